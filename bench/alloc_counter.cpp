@@ -0,0 +1,118 @@
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<size_t> allocationBytes{0};
+static std::atomic<size_t> liveBytes{0};
+
+size_t allocLiveBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+static void *counted(void *p)
+{
+    liveBytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return p;
+}
+
+static void countedFree(void *p) noexcept
+{
+    if (p)
+    {
+        liveBytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+
+AllocCounters allocCounters()
+{
+    return {allocationCount.load(std::memory_order_relaxed), allocationBytes.load(std::memory_order_relaxed)};
+}
+
+static void *countedAlloc(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return counted(p);
+    }
+    throw std::bad_alloc();
+}
+
+static void *countedAlignedAlloc(size_t size, std::align_val_t align)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t alignment = static_cast<size_t>(align);
+    if (void *p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    {
+        return counted(p);
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size)
+{
+    return countedAlloc(size);
+}
+
+void *operator new[](size_t size)
+{
+    return countedAlloc(size);
+}
+
+void *operator new(size_t size, std::align_val_t align)
+{
+    return countedAlignedAlloc(size, align);
+}
+
+void *operator new[](size_t size, std::align_val_t align)
+{
+    return countedAlignedAlloc(size, align);
+}
+
+void operator delete(void *p) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept
+{
+    countedFree(p);
+}
+
+void operator delete[](void *p, size_t, std::align_val_t) noexcept
+{
+    countedFree(p);
+}
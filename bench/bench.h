@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+struct AllocCounters
+{
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * Totals of operator new calls since the program started,
+ * counted by the replacement operators in alloc_counter.cpp
+ */
+AllocCounters allocCounters();
+
+/**
+ * Bytes currently held by operator new allocations, as malloc sized them
+ */
+size_t allocLiveBytes();
+
+/**
+ * Counts allocations made between construction and a call to delta()
+ */
+class AllocScope
+{
+    AllocCounters start = allocCounters();
+
+public:
+    AllocCounters delta() const
+    {
+        auto now = allocCounters();
+        return {now.count - start.count, now.bytes - start.bytes};
+    }
+};
+
+template <class Func>
+double timeMs(Func &&func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+ * Runs func `runs` times and returns the fastest run in milliseconds
+ */
+template <class Func>
+double bestOfMs(int runs, Func &&func)
+{
+    double best = 0;
+    for (int i = 0; i < runs; i++)
+    {
+        double ms = timeMs(func);
+        if (i == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+inline double mbPerSecond(size_t bytes, double ms)
+{
+    return ms > 0 ? (bytes / (1024.0 * 1024.0)) / (ms / 1000.0) : 0;
+}
+
+inline void report(const std::string &name, double value, const char *unit)
+{
+    std::printf("%-48s %14.2f %s\n", name.c_str(), value, unit);
+}
@@ -0,0 +1,42 @@
+#include "bench.h"
+#include "documents.h"
+
+int main()
+{
+    const int records = 100000;
+    const size_t nodes = configRecordsNodeCount(records);
+    const std::string text = configRecords(records).toString();
+
+    report("document size", text.size() / 1024.0, "KiB");
+
+    {
+        AllocScope scope;
+        Sin sin;
+        double parseMs = timeMs([&]
+                                { sin = Sin::parse(text); });
+        auto allocs = scope.delta();
+        double destroyMs = timeMs([&]
+                                  { sin = false; });
+
+        report("heap: parse", parseMs, "ms");
+        report("heap: allocations per node", double(allocs.count) / nodes, "allocs");
+        report("heap: teardown", destroyMs, "ms");
+    }
+
+    {
+        AllocScope scope;
+        auto arena = std::make_unique<SinArena>();
+        Sin sin;
+        double parseMs = timeMs([&]
+                                { sin = Sin::parse(text, *arena); });
+        auto allocs = scope.delta();
+        double destroyMs = timeMs([&]
+                                  { sin = false; arena.reset(); });
+
+        report("arena: parse", parseMs, "ms");
+        report("arena: allocations per node", double(allocs.count) / nodes, "allocs");
+        report("arena: teardown", destroyMs, "ms");
+    }
+
+    return 0;
+}
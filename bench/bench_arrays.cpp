@@ -0,0 +1,40 @@
+#include "bench.h"
+#include "sin.h"
+
+#include <string>
+
+/**
+ * An array whose elements are written at index, index + stride, ...
+ */
+static std::string arrayText(size_t count, size_t stride, bool reversed)
+{
+    std::string text = ": [\n";
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t index = (reversed ? count - 1 - i : i) * stride;
+        text += "  [" + std::to_string(index) + "]: " + std::to_string(i % 1000) + "\n";
+    }
+    text += "]\n";
+    return text;
+}
+
+static void run(const std::string &name, const std::string &text)
+{
+    size_t size = 0;
+    AllocScope allocs;
+    double ms = timeMs([&]
+                       { size = Sin::parse(text).asArray().size(); });
+    auto delta = allocs.delta();
+    report(name + ": parse", ms, "ms");
+    report(name + ": allocations", double(delta.count), "");
+    report(name + ": bytes per slot", double(delta.bytes) / size, "bytes");
+}
+
+int main()
+{
+    run("dense, 1M elements", arrayText(1000000, 1, false));
+    run("dense, 1M elements in reverse", arrayText(1000000, 1, true));
+    run("sparse, 1k elements up to [1M]", arrayText(1000, 1000, false));
+    run("sparse, 1k elements in reverse", arrayText(1000, 1000, true));
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_binary.h"
+
+int main()
+{
+    const Sin sin = configRecords(100000);
+    const std::string text = sin.toString();
+    const std::string binary = sinToBinary(sin);
+
+    report("text size", text.size() / 1024.0, "KiB");
+    report("binary size", binary.size() / 1024.0, "KiB");
+
+    report("text: parse to tree", bestOfMs(3, [&]
+                                           { Sin::parse(text); }),
+           "ms");
+    report("binary: encode", bestOfMs(3, [&]
+                                      { sinToBinary(sin); }),
+           "ms");
+    report("binary: decode to tree", bestOfMs(3, [&]
+                                              { SinBinaryView::root(binary).toSin(); }),
+           "ms");
+
+    // what a worker does at start: read a handful of fields in place
+    double ms = bestOfMs(3, [&]
+                         {
+                             auto root = SinBinaryView::root(binary);
+                             for (size_t i = 0; i < root.size(); i += 1000)
+                             {
+                                 root[i]["port"].asUint16();
+                             }
+                         });
+    report("binary: view, 100 lookups", ms * 1000, "us");
+    return 0;
+}
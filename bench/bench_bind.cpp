@@ -0,0 +1,116 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_bind.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * The records of configRecords as a struct
+ */
+struct ConfigRecord
+{
+    int32_t id = 0;
+    uint16_t port = 0;
+    uint8_t retries = 0;
+    int64_t timeout = 0;
+    double weight = 0;
+    float ratio = 0;
+    bool enabled = false;
+    std::string name;
+    std::vector<int32_t> limits;
+};
+
+SIN_BIND(ConfigRecord, id, port, retries, timeout, weight, ratio, enabled, name, limits)
+
+/**
+ * The usual loader: parse the tree, then copy it member by member
+ */
+static std::vector<ConfigRecord> parseThenWalk(const std::string &text)
+{
+    Sin tree = Sin::parse(text);
+    const auto &array = tree.asArray();
+    std::vector<ConfigRecord> records(array.size());
+    for (size_t i = 0; i < array.size(); i++)
+    {
+        const Sin &fields = array[i];
+        ConfigRecord &record = records[i];
+        const auto &object = fields.asObject();
+        record.id = object.find("id")->second.asInt32();
+        record.port = object.find("port")->second.asUint16();
+        record.retries = object.find("retries")->second.asUint8();
+        record.timeout = object.find("timeout")->second.asInt64();
+        record.weight = object.find("weight")->second.asDouble();
+        record.ratio = object.find("ratio")->second.asFloat();
+        record.enabled = object.find("enabled")->second.asBool();
+        record.name = object.find("name")->second.asString();
+        for (const Sin &limit : object.find("limits")->second.asArray())
+        {
+            record.limits.push_back(limit.asInt32());
+        }
+    }
+    return records;
+}
+
+/**
+ * The usual writer: build the tree, then serialize it
+ */
+static std::string buildThenWrite(const std::vector<ConfigRecord> &records)
+{
+    Sin tree = Sin::Array();
+    auto &array = tree.asArray();
+    array.reserve(records.size());
+    for (const auto &record : records)
+    {
+        Sin &fields = array.emplace_back(Sin::Object());
+        fields["id"] = record.id;
+        fields["port"] = record.port;
+        fields["retries"] = record.retries;
+        fields["timeout"] = record.timeout;
+        fields["weight"] = record.weight;
+        fields["ratio"] = record.ratio;
+        fields["enabled"] = record.enabled;
+        fields["name"] = record.name;
+        Sin &limits = fields["limits"] = Sin::Array();
+        for (int32_t limit : record.limits)
+        {
+            limits.push_back(limit);
+        }
+    }
+    return tree.toString();
+}
+
+int main()
+{
+    const std::string text = configRecords(100000).toString();
+    size_t checksum = 0;
+
+    AllocScope allocs;
+    double ms = bestOfMs(3, [&]
+                         { checksum += parseThenWalk(text).size(); });
+    report("decode: parse, then walk the tree", mbPerSecond(text.size(), ms), "MB/s");
+    report("decode: parse, then walk the tree", allocs.delta().count / 3.0, "allocs");
+
+    allocs = AllocScope();
+    ms = bestOfMs(3, [&]
+                  { checksum += decodeSin<std::vector<ConfigRecord>>(text).size(); });
+    report("decode: decodeSin", mbPerSecond(text.size(), ms), "MB/s");
+    report("decode: decodeSin", allocs.delta().count / 3.0, "allocs");
+
+    const auto records = decodeSin<std::vector<ConfigRecord>>(text);
+
+    allocs = AllocScope();
+    ms = bestOfMs(3, [&]
+                  { checksum += buildThenWrite(records).size(); });
+    report("encode: build the tree, then write", mbPerSecond(text.size(), ms), "MB/s");
+    report("encode: build the tree, then write", allocs.delta().count / 3.0, "allocs");
+
+    allocs = AllocScope();
+    ms = bestOfMs(3, [&]
+                  { checksum += encodeSin(records).size(); });
+    report("encode: encodeSin", mbPerSecond(text.size(), ms), "MB/s");
+    report("encode: encodeSin", allocs.delta().count / 3.0, "allocs");
+
+    std::printf("checksum %zu\n", checksum);
+    return 0;
+}
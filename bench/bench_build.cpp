@@ -0,0 +1,66 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin.h"
+
+#include <cstdio>
+
+/**
+ * configRecords with the move-aware API
+ */
+static Sin configRecordsEmplaced(int count)
+{
+    Sin records = Sin::Array();
+    records.asArray().reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        Sin record;
+        record.asObject().reserve(9);
+        record.emplace("id", i);
+        record.emplace("port", uint16_t(8000 + i % 1000));
+        record.emplace("retries", uint8_t(i % 5));
+        record.emplace("timeout", int64_t(i) * 1000);
+        record.emplace("weight", i * 0.5);
+        record.emplace("ratio", float(i % 100) / 100.0f);
+        record.emplace("enabled", i % 2 == 0);
+        record.emplace("name", "node");
+        Sin &limits = record.emplace("limits", Sin::Array());
+        limits.asArray().reserve(3);
+        limits.push_back(i);
+        limits.push_back(i + 1);
+        limits.push_back(i + 2);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+template <class Func>
+static void run(const char *name, Func &&func)
+{
+    const int count = 100000;
+    const double nodes = double(configRecordsNodeCount(count));
+    int64_t sum = 0;
+
+    AllocScope allocs;
+    double ms = timeMs([&]
+                       { sum += func(count).asArray().size(); });
+    auto delta = allocs.delta();
+    report(std::string(name) + ": allocations", delta.count / nodes, "per node");
+    report(std::string(name) + ": bytes", delta.bytes / nodes, "per node");
+    report(std::string(name) + ": time", ms * 1e6 / nodes, "ns/node");
+    if (sum == 42)
+    {
+        report("", 0, "");
+    }
+}
+
+int main()
+{
+    const std::string text = configRecords(100000).toString();
+    run("Sin::parse", [&](int)
+        { return Sin::parse(text); });
+    run("operator[] and =", [](int count)
+        { return configRecords(count); });
+    run("emplace and push_back", [](int count)
+        { return configRecordsEmplaced(count); });
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin.h"
+
+#include <cstdio>
+#include <string>
+
+/**
+ * What callers had to do before copies were independent
+ */
+static Sin deepCopy(const Sin &sin)
+{
+    switch (sin.typeId())
+    {
+    case SinType::String:
+        return Sin(sin.asStringView(), std::pmr::get_default_resource());
+    case SinType::Array:
+    {
+        Sin copy = Sin::Array();
+        auto &array = copy.asArray();
+        array.reserve(sin.asArray().size());
+        for (const auto &element : sin.asArray())
+        {
+            array.push_back(deepCopy(element));
+        }
+        return copy;
+    }
+    case SinType::Object:
+    {
+        Sin copy = Sin::Object();
+        auto &object = copy.asObject();
+        object.reserve(sin.asObject().size());
+        for (const auto &[key, value] : sin.asObject())
+        {
+            object.appendUnsorted(key, deepCopy(value));
+        }
+        object.sortKeys();
+        return copy;
+    }
+    default:
+        return sin;
+    }
+}
+
+/**
+ * A request's overrides on top of the shared base config
+ */
+static void patch(Sin &config, int request)
+{
+    Sin &route = config["route" + std::to_string(request % 1000)];
+    route["port"] = uint16_t(9000 + request % 100);
+    route["limits"][1] = request;
+}
+
+int main()
+{
+    // a base config of 1000 routes shaped like configRecords
+    Sin records = configRecords(1000);
+    Sin base = Sin::Object();
+    for (size_t i = 0; i < records.asArray().size(); i++)
+    {
+        base["route" + std::to_string(i)] = records[int(i)];
+    }
+
+    const int requests = 2000;
+    int64_t sum = 0;
+
+    AllocScope deepAllocs;
+    double ms = bestOfMs(3, [&]
+                         {
+                             for (int i = 0; i < requests; i++)
+                             {
+                                 Sin config = deepCopy(base);
+                                 patch(config, i);
+                                 sum += config.asObject().size();
+                             } });
+    report("deep copy + patch", ms * 1000 / requests, "us/request");
+    report("deep copy + patch", double(deepAllocs.delta().count) / (3 * requests), "allocs/request");
+
+    AllocScope cowAllocs;
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int i = 0; i < requests; i++)
+                      {
+                          Sin config = base;
+                          patch(config, i);
+                          sum += config.asObject().size();
+                      } });
+    report("copy on write + patch", ms * 1000 / requests, "us/request");
+    report("copy on write + patch", double(cowAllocs.delta().count) / (3 * requests), "allocs/request");
+
+    std::printf("checksum %lld\n", (long long)sum);
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "bench.h"
+#include "documents.h"
+
+/**
+ * Output size and time per document for each layout. Times are
+ * per document rather than MB/s since the layouts differ in size.
+ */
+static void run(const std::string &name, const Sin &sin, const SinFormat &format)
+{
+    std::string text;
+    sin.toString(text, format);
+    report(name + ": size", text.size() / 1024.0, "KiB");
+
+    std::string out;
+    double ms = bestOfMs(5, [&]
+                         { out.clear(); sin.toString(out, format); });
+    report(name + ": serialize", ms, "ms");
+
+    ms = bestOfMs(5, [&]
+                  { Sin::parse(text); });
+    report(name + ": parse", ms, "ms");
+}
+
+int main()
+{
+    const Sin sin = configRecords(100000);
+
+    SinFormat pretty;
+    run("pretty, 2 spaces", sin, pretty);
+
+    SinFormat tabs;
+    tabs.indent = 1;
+    tabs.indentChar = '\t';
+    run("pretty, 1 tab", sin, tabs);
+
+    SinFormat compact;
+    compact.compact = true;
+    run("compact", sin, compact);
+    return 0;
+}
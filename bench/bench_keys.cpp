@@ -0,0 +1,54 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin.h"
+
+#include <cstdio>
+
+static double mib(size_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+int main()
+{
+    // 9 keys repeated in every record
+    const int records = 200000;
+    const std::string text = configRecords(records).toString();
+    const size_t members = size_t(records) * 9;
+    std::printf("document: %.1f MiB, %zu members\n", mib(text.size()), members);
+
+    uint64_t sum = 0;
+
+    size_t live = allocLiveBytes();
+    double ms = timeMs([&]
+                       {
+                           Sin tree = Sin::parse(text);
+                           size_t held = allocLiveBytes() - live;
+                           report("Sin::parse held", mib(held), "MiB");
+                           report("Sin::parse held per member", double(held) / members, "bytes");
+                           sum += tree[records / 2]["port"].asUint16(); });
+    report("Sin::parse", mbPerSecond(text.size(), ms), "MB/s");
+
+    Sin tree = Sin::parse(text);
+    report("distinct keys in the pool", double(SinKey::poolSize()), "keys");
+
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int i = 0; i < records; i++)
+                      {
+                          sum += tree.asArray()[i].asObject().find("port")->second.asUint16();
+                      } });
+    report("find by text", ms * 1e6 / records, "ns/lookup");
+
+    const SinKey port("port");
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int i = 0; i < records; i++)
+                      {
+                          sum += tree.asArray()[i].asObject().find(port)->second.asUint16();
+                      } });
+    report("find by SinKey", ms * 1e6 / records, "ns/lookup");
+
+    std::printf("checksum %llu\n", (unsigned long long)sum);
+    return 0;
+}
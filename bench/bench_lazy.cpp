@@ -0,0 +1,48 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_lazy.h"
+
+#include <cstdio>
+
+static double mib(size_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+int main()
+{
+    // ~50 MB of text
+    const int records = 220000;
+    const std::string text = configRecords(records).toString();
+    std::printf("document: %.1f MiB\n", mib(text.size()));
+
+    uint64_t sum = 0;
+
+    size_t live = allocLiveBytes();
+    double ms = timeMs([&]
+                       {
+                           Sin tree = Sin::parse(text);
+                           report("Sin::parse held", mib(allocLiveBytes() - live), "MiB");
+                           sum += tree[records / 2]["port"].asUint16(); });
+    report("Sin::parse to first lookup", ms, "ms");
+
+    live = allocLiveBytes();
+    ms = timeMs([&]
+                {
+                    SinLazyDocument lazy(text);
+                    report("SinLazyDocument held, text copy included", mib(allocLiveBytes() - live), "MiB");
+                    sum += lazy.root()[records / 2]["port"].asUint16(); });
+    report("SinLazyDocument to first lookup", ms, "ms");
+
+    SinLazyDocument lazy(text);
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int i = 0; i < records; i += 1000)
+                      {
+                          sum += lazy.root()[i]["port"].asUint16();
+                      } });
+    report("SinLazyDocument 220 more lookups", ms, "ms");
+
+    std::printf("checksum %llu\n", (unsigned long long)sum);
+    return 0;
+}
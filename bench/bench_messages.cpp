@@ -0,0 +1,73 @@
+#include "bench.h"
+#include "sin_parser.h"
+#include "sin_parser_impl.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Small messages like the ones of a config reload loop
+ */
+static std::vector<std::string> messages(int count)
+{
+    std::vector<std::string> result;
+    for (int i = 0; i < count; i++)
+    {
+        Sin message = Sin::Object();
+        message["service"] = "frontend-" + std::to_string(i % 10);
+        message["description"] = std::string("reload \"requested\" by the scheduler");
+        message["revision"] = int64_t(1000 + i);
+        message["weight"] = i * 0.25;
+        message["enabled"] = i % 3 != 0;
+        message["limits"]["connections"] = uint16_t(100 + i % 50);
+        message["limits"]["timeout ms"] = uint32_t(2500);
+        message["hosts"] = {"a.example", "b.example", "c.example"};
+        result.push_back(message.toString());
+    }
+    return result;
+}
+
+int main()
+{
+    const auto documents = messages(1000);
+    size_t bytes = 0;
+    for (const auto &document : documents)
+    {
+        bytes += document.size();
+    }
+    report("message size", double(bytes) / documents.size(), "bytes");
+
+    const int rounds = 50;
+    const double count = double(documents.size()) * rounds;
+    int64_t sum = 0;
+
+    AllocScope allocs;
+    double ms = bestOfMs(3, [&]
+                         {
+                             for (int round = 0; round < rounds; round++)
+                             {
+                                 for (const auto &document : documents)
+                                 {
+                                     sum += parseSin(document).asObject().size();
+                                 }
+                             } });
+    report("parseSin", count / ms * 1000, "messages/s");
+    report("parseSin", allocs.delta().count / (3 * count), "allocs/message");
+
+    SinParser parser;
+    allocs = AllocScope();
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int round = 0; round < rounds; round++)
+                      {
+                          for (const auto &document : documents)
+                          {
+                              sum += parser.parse(document).asObject().size();
+                          }
+                      } });
+    report("reused SinParser", count / ms * 1000, "messages/s");
+    report("reused SinParser", allocs.delta().count / (3 * count), "allocs/message");
+
+    std::printf("checksum %lld\n", (long long)sum);
+    return 0;
+}
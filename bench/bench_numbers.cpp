@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "sin.h"
+
+/**
+ * Number-heavy documents: untyped integers and doubles go through the
+ * classification path, typed values through the range-checked path
+ */
+static std::string untypedIntegers(int count)
+{
+    std::string text = ": [\n";
+    for (int i = 0; i < count; i++)
+    {
+        text += "  [" + std::to_string(i) + "]: " + std::to_string((i * 7919) - count) + "\n";
+    }
+    return text + "]\n";
+}
+
+static std::string untypedDoubles(int count)
+{
+    std::string text = ": [\n";
+    for (int i = 0; i < count; i++)
+    {
+        text += "  [" + std::to_string(i) + "]: " + std::to_string(i * 0.37 - 1000.5) + "\n";
+    }
+    return text + "]\n";
+}
+
+static std::string typedMix(int count)
+{
+    static const char *types[] = {"Int8", "Uint16", "Int64", "Float", "Double"};
+    std::string text = ": {\n";
+    for (int i = 0; i < count; i++)
+    {
+        std::string value = i % 5 >= 3 ? std::to_string(i * 0.25) : std::to_string(i % 100);
+        text += "  .v" + std::to_string(i) + ": " + types[i % 5] + " " + value + "\n";
+    }
+    return text + "}\n";
+}
+
+static void run(const std::string &name, const std::string &text)
+{
+    double ms = bestOfMs(5, [&]
+                         { Sin::parse(text); });
+    report(name + ": parse", mbPerSecond(text.size(), ms), "MB/s");
+}
+
+int main()
+{
+    run("untyped integers", untypedIntegers(200000));
+    run("untyped doubles", untypedDoubles(200000));
+    run("typed numbers", typedMix(200000));
+    return 0;
+}
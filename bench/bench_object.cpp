@@ -0,0 +1,82 @@
+#include "bench.h"
+#include "sin.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Keyed lookups in an object with `size` members, in random order
+ */
+static void run(size_t size)
+{
+    Sin object = Sin::Object();
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < size; i++)
+    {
+        keys.push_back("member_" + std::to_string(i * 7919 % size));
+        object[keys.back()] = int(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+
+    const size_t lookups = 2000000;
+    int64_t sum = 0;
+
+    double ms = bestOfMs(3, [&]
+                         {
+                             for (size_t i = 0; i < lookups; i++)
+                             {
+                                 sum += object[keys[i % size]].asInt32();
+                             } });
+    report(std::to_string(size) + " keys: sin[key]", ms * 1e6 / lookups, "ns/lookup");
+
+    const SinObject &members = object.asObject();
+    ms = bestOfMs(3, [&]
+                  {
+                      for (size_t i = 0; i < lookups; i++)
+                      {
+                          sum += members.find(keys[i % size])->second.asInt32();
+                      } });
+    report(std::to_string(size) + " keys: asObject().find(key)", ms * 1e6 / lookups, "ns/lookup");
+
+    ms = timeMs([&]
+                {
+                    Sin built = Sin::Object();
+                    for (const auto &key : keys)
+                    {
+                        built[key] = 1;
+                    } });
+    report(std::to_string(size) + " keys: build in random order", ms * 1e6 / size, "ns/member");
+
+    // erase a tenth of the members, then all but a tenth
+    ms = timeMs([&]
+                {
+                    for (size_t i = 0; i < size / 10; i++)
+                    {
+                        sum += object.asObject().erase(keys[i]);
+                    } });
+    report(std::to_string(size) + " keys: erase a tenth", ms * 1e6 / (size / 10), "ns/erase");
+
+    ms = timeMs([&]
+                {
+                    for (size_t i = size / 10; i < size - size / 10; i++)
+                    {
+                        sum += object.asObject().erase(keys[i]);
+                    } });
+    report(std::to_string(size) + " keys: erase down to a tenth", ms * 1e6 / (size - size / 10 * 2), "ns/erase");
+
+    if (sum == 42)
+    {
+        report("", 0, "");
+    }
+}
+
+int main()
+{
+    for (size_t size : {10, 1000, 100000})
+    {
+        run(size);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "sin.h"
+#include "sin_binary.h"
+
+#include <cstdio>
+#include <string>
+
+static double mib(size_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+/**
+ * Calibration tables: arrays of floats and of Int32
+ */
+static Sin tables(int count, int size)
+{
+    Sin root = Sin::Object();
+    for (int t = 0; t < count; t++)
+    {
+        Sin weights = Sin::Array();
+        Sin offsets = Sin::Array();
+        for (int i = 0; i < size; i++)
+        {
+            weights.asArray().push_back(float(i % 1000) * 0.001f + float(t));
+            offsets.asArray().push_back(int32_t(i * 7 - t));
+        }
+        root["weights" + std::to_string(t)] = std::move(weights);
+        root["offsets" + std::to_string(t)] = std::move(offsets);
+    }
+    return root;
+}
+
+int main()
+{
+    const int count = 50;
+    const int size = 20000;
+    const std::string text = tables(count, size).toString();
+    const double elements = 2.0 * count * size;
+    std::printf("document: %.1f MiB\n", mib(text.size()));
+
+    double sum = 0;
+    size_t live = allocLiveBytes();
+    double ms = timeMs([&]
+                       {
+                           Sin tree = Sin::parse(text);
+                           report("Sin::parse held", mib(allocLiveBytes() - live), "MiB");
+                           sum += tree["offsets1"].asArray().size(); });
+    report("Sin::parse", mbPerSecond(text.size(), ms), "MB/s");
+
+    Sin tree = Sin::parse(text);
+    std::string out;
+    ms = bestOfMs(3, [&]
+                  {
+                      out.clear();
+                      tree.toString(out); });
+    report("toString", mbPerSecond(out.size(), ms), "MB/s");
+
+    // encoding reads the packed buffers, the tree holds no more afterwards
+    live = allocLiveBytes();
+    std::string binary;
+    ms = bestOfMs(3, [&]
+                  {
+                      binary.clear();
+                      sinToBinary(tree, binary); });
+    report("sinToBinary", mbPerSecond(binary.size(), ms), "MB/s");
+    report("sinToBinary held", mib(allocLiveBytes() - live - binary.capacity()), "MiB");
+
+    // the sum every consumer of a weight table does, on a copy whose tables
+    // are unpacked by the non-const asArray()
+    Sin unpacked = tree;
+    for (int t = 0; t < count; t++)
+    {
+        unpacked["weights" + std::to_string(t)].asArray();
+    }
+    const Sin &constUnpacked = unpacked;
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int t = 0; t < count; t++)
+                      {
+                          for (const Sin &weight : constUnpacked.asObject().find("weights" + std::to_string(t))->second.asArray())
+                          {
+                              sum += weight.asFloat();
+                          }
+                      } });
+    report("sum through asArray(), unpacked", ms * 1e6 / (elements / 2), "ns/element");
+
+    const Sin &constTree = tree;
+
+    ms = bestOfMs(3, [&]
+                  {
+                      for (int t = 0; t < count; t++)
+                      {
+                          for (float weight : constTree.asObject().find("weights" + std::to_string(t))->second.asSpan<float>())
+                          {
+                              sum += weight;
+                          }
+                      } });
+    report("sum through asSpan<float>()", ms * 1e6 / (elements / 2), "ns/element");
+
+    std::printf("checksum %.1f\n", sum);
+    return 0;
+}
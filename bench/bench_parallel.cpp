@@ -0,0 +1,46 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_parser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+int main()
+{
+    const std::string array = configRecords(200000).toString();
+
+    // the same records as members of the root object
+    Sin records = configRecords(200000);
+    Sin routes = Sin::Object();
+    for (size_t i = 0; i < records.asArray().size(); i++)
+    {
+        routes["route" + std::to_string(i)] = records[int(i)];
+    }
+    const std::string object = routes.toString();
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%u cores\n", cores);
+
+    for (auto [name, text] : {std::pair{"array", &array}, std::pair{"object", &object}})
+    {
+        double sequential = bestOfMs(3, [&]
+                                     { parseSin(*text); });
+        report(std::string(name) + ": parseSin", mbPerSecond(text->size(), sequential), "MB/s");
+
+        // the pre-scan and the entry parses without any threads, what splitting costs
+        double split = bestOfMs(3, [&]
+                                { parseSinParallel(*text, 1); });
+        report(std::string(name) + ": pre-scan + entries, 1 thread", mbPerSecond(text->size(), split), "MB/s");
+        report(std::string(name) + ": pre-scan + entries overhead", (split / sequential - 1) * 100, "%");
+
+        for (unsigned threads = 2; threads <= 2 * cores; threads *= 2)
+        {
+            double ms = bestOfMs(3, [&]
+                                 { parseSinParallel(*text, threads); });
+            report(std::string(name) + ": " + std::to_string(threads) + " threads", mbPerSecond(text->size(), ms), "MB/s");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "bench.h"
+#include "documents.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+int main()
+{
+    const Sin records = configRecords(200000);
+    const std::string expected = records.toString();
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%u cores, %.1f MiB of text\n", cores, expected.size() / (1024.0 * 1024.0));
+
+    double ms = bestOfMs(3, [&]
+                         { records.toString(); });
+    report("toString", mbPerSecond(expected.size(), ms), "MB/s");
+
+    for (unsigned threads = 1; threads <= 2 * cores; threads *= 2)
+    {
+        std::string text;
+        ms = bestOfMs(3, [&]
+                      { text = records.toStringParallel(threads); });
+        report("toStringParallel, " + std::to_string(threads) + " threads", mbPerSecond(expected.size(), ms), "MB/s");
+        if (text != expected)
+        {
+            std::printf("output differs from toString\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_parser.h"
+
+/**
+ * Counts events, which is the least a handler can do
+ */
+struct CountingHandler : SinSaxHandler
+{
+    size_t events = 0;
+
+    SinSaxAction onObjectBegin() override { return count(); }
+    SinSaxAction onArrayBegin() override { return count(); }
+    SinSaxAction onKey(std::string_view) override { return count(); }
+    SinSaxAction onArrayIndex(size_t) override { return count(); }
+    SinSaxAction onScalar(const SinSaxScalar &) override { return count(); }
+    SinSaxAction onEnd() override { return count(); }
+
+    SinSaxAction count()
+    {
+        events++;
+        return SinSaxAction::Continue;
+    }
+};
+
+/**
+ * Reads the port of every 1000th record and skips the rest
+ */
+struct PortsHandler : SinSaxHandler
+{
+    size_t depth = 0;
+    size_t index = 0;
+    bool port = false;
+    uint64_t sum = 0;
+
+    SinSaxAction onObjectBegin() override
+    {
+        depth++;
+        return SinSaxAction::Continue;
+    }
+    SinSaxAction onArrayBegin() override
+    {
+        depth++;
+        return SinSaxAction::Continue;
+    }
+    SinSaxAction onKey(std::string_view key) override
+    {
+        port = key == "port";
+        return port ? SinSaxAction::Continue : SinSaxAction::Skip;
+    }
+    SinSaxAction onArrayIndex(size_t i) override
+    {
+        index = i;
+        return i % 1000 == 0 ? SinSaxAction::Continue : SinSaxAction::Skip;
+    }
+    SinSaxAction onScalar(const SinSaxScalar &scalar) override
+    {
+        sum += scalar.value.Uint16;
+        return SinSaxAction::Continue;
+    }
+    SinSaxAction onEnd() override
+    {
+        depth--;
+        return SinSaxAction::Continue;
+    }
+};
+
+int main()
+{
+    const std::string text = configRecords(100000).toString();
+
+    double ms = bestOfMs(3, [&]
+                         { Sin::parse(text); });
+    report("tree", mbPerSecond(text.size(), ms), "MB/s");
+
+    ms = bestOfMs(3, [&]
+                  { CountingHandler handler; parseSin(text, handler); });
+    report("events only", mbPerSecond(text.size(), ms), "MB/s");
+
+    ms = bestOfMs(3, [&]
+                  { PortsHandler handler; parseSin(text, handler); });
+    report("100 ports, skipping the rest", mbPerSecond(text.size(), ms), "MB/s");
+    return 0;
+}
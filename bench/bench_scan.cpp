@@ -0,0 +1,75 @@
+#include "bench.h"
+#include "sin.h"
+#include "sin_scan.h"
+
+/**
+ * Inputs that stress one scanning path each: indentation whitespace,
+ * string bodies with escapes, and short keys with typed numbers
+ */
+static std::string deeplyIndented(int depth, int width)
+{
+    std::string text = ": {\n";
+    for (int d = 1; d <= depth; d++)
+    {
+        std::string pad(d * 8, ' ');
+        for (int i = 0; i < width; i++)
+        {
+            text += pad + ".k" + std::to_string(i) + ": true\n";
+        }
+        text += pad + ".next: {\n";
+    }
+    for (int d = depth; d >= 0; d--)
+    {
+        text += std::string(d * 8, ' ') + "}\n";
+    }
+    return text;
+}
+
+static std::string longStrings(int count)
+{
+    std::string body(2000, 'x');
+    for (size_t i = 100; i < body.size(); i += 250)
+    {
+        body[i] = '\\';
+        body[i + 1] = 'n';
+    }
+    std::string lines;
+    for (int i = 0; i < 40; i++)
+    {
+        lines += "MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAz0\n";
+    }
+
+    std::string text = ": {\n";
+    for (int i = 0; i < count; i++)
+    {
+        text += "  .s" + std::to_string(i) + ": \"" + body + "\"\n";
+        text += "  .b" + std::to_string(i) + ": `\n" + lines + "`\n";
+    }
+    return text + "}\n";
+}
+
+static std::string typedNumbers(int count)
+{
+    std::string text = ": {\n";
+    for (int i = 0; i < count; i++)
+    {
+        text += "  .port" + std::to_string(i) + ": Uint16\n  " + std::to_string(i % 65536) + "\n";
+    }
+    return text + "}\n";
+}
+
+static void run(const std::string &name, const std::string &text)
+{
+    double ms = bestOfMs(5, [&]
+                         { Sin::parse(text); });
+    report(name + ": parse", mbPerSecond(text.size(), ms), "MB/s");
+}
+
+int main()
+{
+    std::printf("scan kernels: %s\n", sinScanKernels().name);
+    run("indentation", deeplyIndented(200, 200));
+    run("string bodies", longStrings(2000));
+    run("keys and typed numbers", typedNumbers(100000));
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "bench.h"
+#include "documents.h"
+
+#include <fstream>
+
+/**
+ * Objects nested `depth` levels deep, each with a few scalar siblings
+ */
+static Sin nestedObjects(int depth)
+{
+    Sin root = Sin::Object();
+    Sin *level = &root;
+    for (int d = 0; d < depth; d++)
+    {
+        (*level)["id"] = d;
+        (*level)["name"] = "level";
+        level = &(*level)["child"];
+    }
+    return root;
+}
+
+/**
+ * Records of numbers of every type, too mixed to be packed, so that each
+ * value is dispatched on its own type
+ */
+static Sin numericRecords(int count)
+{
+    Sin records = Sin::Array();
+    auto &array = records.asArray();
+    for (int i = 0; i < count; i++)
+    {
+        Sin record = Sin::Array();
+        auto &values = record.asArray();
+        values.push_back(uint8_t(i));
+        values.push_back(int8_t(-i));
+        values.push_back(uint16_t(i * 3));
+        values.push_back(int16_t(-i * 3));
+        values.push_back(uint32_t(i) * 1000);
+        values.push_back(int32_t(i) * -1000);
+        values.push_back(uint64_t(i) << 33);
+        values.push_back(-(int64_t(i) << 33));
+        values.push_back(float(i) * 0.5f);
+        values.push_back(i * 0.125);
+        values.push_back(i % 2 == 0);
+        array.push_back(std::move(record));
+    }
+    return records;
+}
+
+static void run(const std::string &name, const Sin &sin)
+{
+    const size_t size = sin.toString().size();
+
+    {
+        AllocScope scope;
+        double ms = bestOfMs(5, [&]
+                             { sin.toString(); });
+        report(name + ": toString()", mbPerSecond(size, ms), "MB/s");
+        report(name + ": toString() allocations", double(scope.delta().count) / 5, "allocs");
+    }
+
+    {
+        std::string out;
+        sin.toString(out);
+        AllocScope scope;
+        double ms = bestOfMs(5, [&]
+                             { out.clear(); sin.toString(out); });
+        report(name + ": toString(out), reused buffer", mbPerSecond(size, ms), "MB/s");
+        report(name + ": toString(out) allocations", double(scope.delta().count) / 5, "allocs");
+    }
+
+    {
+        std::ofstream file("/dev/null");
+        double ms = bestOfMs(5, [&]
+                             { SinWriter writer(file); sin.serialize(writer); });
+        report(name + ": serialize(ostream)", mbPerSecond(size, ms), "MB/s");
+    }
+}
+
+int main()
+{
+    run("config records", configRecords(100000));
+    run("nested objects", nestedObjects(2000));
+    run("numeric records", numericRecords(100000));
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "bench.h"
+#include "documents.h"
+
+int main()
+{
+    const int records = 100000;
+    const size_t nodes = configRecordsNodeCount(records);
+
+    report("sizeof(Sin)", sizeof(Sin), "bytes");
+
+    AllocScope buildScope;
+    Sin tree;
+    double buildMs = timeMs([&]
+                            { tree = configRecords(records); });
+    auto built = buildScope.delta();
+
+    report("build: allocations per node", double(built.count) / nodes, "allocs");
+    report("build: heap bytes per node", double(built.bytes) / nodes, "bytes");
+    report("build: time", buildMs, "ms");
+
+    std::string text = tree.toString();
+
+    AllocScope parseScope;
+    Sin parsed;
+    double parseMs = timeMs([&]
+                            { parsed = Sin::parse(text); });
+    auto afterParse = parseScope.delta();
+
+    report("parse: allocations per node", double(afterParse.count) / nodes, "allocs");
+    report("parse: time", parseMs, "ms");
+
+    double destroyMs = timeMs([&]
+                              { tree = Sin{}; parsed = Sin{}; });
+    report("destroy both trees: time", destroyMs, "ms");
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "bench.h"
+#include "documents.h"
+#include "sin_stream_parser.h"
+
+static void feedInChunks(const std::string &text, size_t chunk)
+{
+    SinStreamParser parser;
+    for (size_t pos = 0; pos < text.size(); pos += chunk)
+    {
+        parser.feed(text.data() + pos, std::min(chunk, text.size() - pos));
+    }
+    parser.finish();
+}
+
+int main()
+{
+    // one record per member of the root object, like a keyed config
+    Sin records = Sin::Object();
+    Sin list = configRecords(100000);
+    for (size_t i = 0; i < list.asArray().size(); i++)
+    {
+        records["record" + std::to_string(i)] = list[i];
+    }
+    const std::string text = records.toString();
+
+    double ms = bestOfMs(3, [&]
+                         { Sin::parse(text); });
+    report("whole document", mbPerSecond(text.size(), ms), "MB/s");
+
+    for (size_t chunk : {size_t(512), size_t(4096), size_t(65536), size_t(1 << 20)})
+    {
+        ms = bestOfMs(3, [&]
+                      { feedInChunks(text, chunk); });
+        report("stream, " + std::to_string(chunk) + " byte chunks", mbPerSecond(text.size(), ms), "MB/s");
+    }
+    return 0;
+}
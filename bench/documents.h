@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sin.h"
+
+/**
+ * Builds a tree shaped like our service configs: mostly numbers and bools,
+ * with a string and a small array per record
+ */
+inline Sin configRecords(int count)
+{
+    Sin records = Sin::Array();
+    auto &array = records.asArray();
+    for (int i = 0; i < count; i++)
+    {
+        Sin record = Sin::Object();
+        auto &fields = record.asObject();
+        fields["id"] = i;
+        fields["port"] = uint16_t(8000 + i % 1000);
+        fields["retries"] = uint8_t(i % 5);
+        fields["timeout"] = int64_t(i) * 1000;
+        fields["weight"] = i * 0.5;
+        fields["ratio"] = float(i % 100) / 100.0f;
+        fields["enabled"] = i % 2 == 0;
+        fields["name"] = "node";
+        fields["limits"] = {i, i + 1, i + 2};
+        array.push_back(record);
+    }
+    return records;
+}
+
+// root + per record: object, 7 scalars, string, array and 3 elements
+inline size_t configRecordsNodeCount(int count)
+{
+    return 1 + size_t(count) * 13;
+}
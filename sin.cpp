@@ -1,56 +1,244 @@
 #include "sin.h"
 #include "sin_parser.h"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+static void typeAssertion(const char *requested, SinType actual)
+{
+    std::cout << "\nType assertion. Requested type: " << requested << ", Actual type: " << sinTypeName(actual) << std::endl
+              << std::endl;
+    throw std::string("Type assertion. Requested type: ") + requested + ", Actual type: " + sinTypeName(actual);
+}
+
+/**
+ * Allocates a node, together with its shared_ptr control block, from the resource
+ */
+template <class T, class... Args>
+static std::shared_ptr<T> makeNode(std::pmr::memory_resource *resource, Args &&...args)
+{
+    return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), std::forward<Args>(args)..., resource);
+}
+
+void Sin::typeMismatch(const char *requested, SinType actual)
+{
+    typeAssertion(requested, actual);
+}
+
+bool Sin::hasNode(SinType type)
+{
+    return type == SinType::String || type == SinType::Array || type == SinType::Object;
+}
+
+void Sin::setNode(SinType type, std::shared_ptr<SinValue> node)
+{
+    release();
+    new (&_value) std::shared_ptr<SinValue>(std::move(node));
+    _type = type;
+    _packed = false;
+}
+
+void Sin::release()
+{
+    if (hasNode(_type))
+    {
+        _value.~shared_ptr();
+    }
+    _type = SinType::Undefined;
+    _packed = false;
+    _scalar = {};
+}
+
+/**
+ * Copy on write: a node that other values share is replaced by a copy of
+ * it before it is changed. The copy shares the children, they are copied
+ * in turn when they are changed through it. An empty object made by Sin()
+ * gets its node here. Copies go to the default resource, never to the
+ * shared node's: an arena never frees and isn't safe to share between
+ * threads patching their own copies.
+ */
+void Sin::detach()
+{
+    if (_packed)
+    {
+        // the unpacked node belongs to this value alone
+        unpack();
+        return;
+    }
+    if ((_type != SinType::Array && _type != SinType::Object) || _value.use_count() == 1)
+    {
+        return;
+    }
+
+    // strings are never changed in place, only containers get here
+    std::shared_ptr<SinValue> node;
+    if (!_value)
+    {
+        node = makeNode<TObject>(std::pmr::get_default_resource());
+    }
+    else if (_type == SinType::Array)
+    {
+        const auto &shared = static_cast<TArray *>(_value.get())->value;
+        auto array = makeNode<TArray>(std::pmr::get_default_resource());
+        // assignment keeps the new node's allocator
+        array->value = shared;
+        node = std::move(array);
+    }
+    else
+    {
+        const auto &shared = static_cast<TObject *>(_value.get())->value;
+        auto object = makeNode<TObject>(std::pmr::get_default_resource());
+        object->value = shared;
+        node = std::move(object);
+    }
+    setNode(_type, std::move(node));
+}
 
-Sin::Sin()
+/**
+ * An empty object without a node, so that placeholders and values that are
+ * assigned right away don't allocate
+ */
+Sin::Sin() : _scalar{}
 {
-    _type = "Object";
-    _value = std::make_shared<TObject>();
+    setNode(SinType::Object, nullptr);
 }
 
-Sin::Sin(const char *str)
+Sin::Sin(const char *str) : _scalar{}
 {
-    _type = "String";
-    _value = std::make_shared<String>(std::string(str));
+    setNode(SinType::String, makeNode<String>(std::pmr::get_default_resource(), str));
 }
 
-Sin::Sin(std::initializer_list<Sin> list)
+Sin::Sin(std::initializer_list<Sin> list) : _scalar{}
 {
-    _type = "Array";
-    _value = std::make_shared<TArray>();
+    auto array = makeNode<TArray>(std::pmr::get_default_resource());
+    array->value.reserve(list.size());
 
-    for (auto el : list)
+    for (auto &el : list)
     {
-        dynamic_cast<TArray *>(_value.get())->value.push_back(el);
+        array->value.push_back(el);
     }
+
+    setNode(SinType::Array, std::move(array));
+}
+
+Sin::Sin(SinType type, std::shared_ptr<SinValue> node) : _scalar{}
+{
+    setNode(type, std::move(node));
+}
+
+Sin::Sin(std::string_view str, std::pmr::memory_resource *resource) : _scalar{}
+{
+    setNode(SinType::String, makeNode<String>(resource, str));
 }
 
-Sin Sin::parse(const std::string &str)
+Sin::Sin(const Sin &other) : _type{other._type}, _packed{other._packed}, _scalar{}
+{
+    if (hasNode(_type))
+    {
+        new (&_value) std::shared_ptr<SinValue>(other._value);
+    }
+    else
+    {
+        _scalar = other._scalar;
+    }
+}
+
+Sin::Sin(Sin &&other) noexcept : _type{other._type}, _packed{other._packed}, _scalar{}
+{
+    if (hasNode(_type))
+    {
+        new (&_value) std::shared_ptr<SinValue>(std::move(other._value));
+        other.release();
+    }
+    else
+    {
+        _scalar = other._scalar;
+    }
+}
+
+Sin &Sin::operator=(const Sin &other)
+{
+    // copy first, other may be owned by this value
+    return *this = Sin(other);
+}
+
+Sin &Sin::operator=(Sin &&other) noexcept
+{
+    if (this != &other)
+    {
+        Sin moved(std::move(other));
+        release();
+        _type = moved._type;
+        _packed = moved._packed;
+        if (hasNode(_type))
+        {
+            new (&_value) std::shared_ptr<SinValue>(std::move(moved._value));
+            moved.release();
+        }
+        else
+        {
+            _scalar = moved._scalar;
+        }
+    }
+    return *this;
+}
+
+Sin &Sin::operator=(const char *str)
+{
+    setNode(SinType::String, makeNode<String>(std::pmr::get_default_resource(), str));
+    return *this;
+}
+
+Sin &Sin::operator=(std::initializer_list<Sin> list)
+{
+    return *this = list.size() == 0 ? Sin() : Sin(list);
+}
+
+Sin::~Sin()
+{
+    release();
+}
+
+Sin Sin::parse(std::string_view str)
 {
     return parseSin(str);
 }
 
-#define SIN_STANDARD_TYPE_SETTER_GETTER(SIN_TYPE, STANDARD_TYPE)                                               \
-    Sin::Sin(const STANDARD_TYPE &value)                                                                       \
-    {                                                                                                          \
-        _type = #SIN_TYPE;                                                                                     \
-        _value = std::make_shared<SIN_TYPE>(value);                                                            \
-    }                                                                                                          \
-    void Sin::operator=(STANDARD_TYPE &value)                                                                  \
-    {                                                                                                          \
-        _type = #SIN_TYPE;                                                                                     \
-        _value = std::make_shared<SIN_TYPE>(value);                                                            \
-    }                                                                                                          \
-    STANDARD_TYPE Sin::as##SIN_TYPE() const                                                                    \
-    {                                                                                                          \
-        if (_type != #SIN_TYPE)                                                                                \
-        {                                                                                                      \
-            std::cout << "\nType assertion. Requested type: " #SIN_TYPE ", Actual type: " + _type << std::endl \
-                      << std::endl;                                                                            \
-            throw "Type assertion. Requested type: " #SIN_TYPE ", Actual type: " + _type;                      \
-        }                                                                                                      \
-        return dynamic_cast<SIN_TYPE *>(_value.get())->value;                                                  \
+Sin Sin::parse(std::string_view str, SinArena &arena)
+{
+    return parseSin(str, arena.resource());
+}
+
+#define SIN_STANDARD_TYPE_SETTER_GETTER(SIN_TYPE, STANDARD_TYPE) \
+    Sin::Sin(const STANDARD_TYPE &value) : _scalar{}             \
+    {                                                            \
+        _type = SinType::SIN_TYPE;                               \
+        _scalar.SIN_TYPE = value;                                \
+    }                                                            \
+    Sin &Sin::operator=(const STANDARD_TYPE &value)              \
+    {                                                            \
+        release();                                               \
+        _type = SinType::SIN_TYPE;                               \
+        _scalar.SIN_TYPE = value;                                \
+        return *this;                                            \
+    }                                                            \
+    STANDARD_TYPE Sin::as##SIN_TYPE() const                      \
+    {                                                            \
+        if (_type != SinType::SIN_TYPE)                          \
+        {                                                        \
+            typeAssertion(#SIN_TYPE, _type);                     \
+        }                                                        \
+        return _scalar.SIN_TYPE;                                 \
     }
 
 SIN_STANDARD_TYPE_SETTER_GETTER(Uint8, uint8_t);
@@ -63,239 +251,608 @@ SIN_STANDARD_TYPE_SETTER_GETTER(Uint64, uint64_t);
 SIN_STANDARD_TYPE_SETTER_GETTER(Int64, int64_t);
 SIN_STANDARD_TYPE_SETTER_GETTER(Float, float);
 SIN_STANDARD_TYPE_SETTER_GETTER(Double, double);
-SIN_STANDARD_TYPE_SETTER_GETTER(String, std::string);
 SIN_STANDARD_TYPE_SETTER_GETTER(Bool, bool);
 
-std::string Sin::_toString(int pads)
+Sin::Sin(const std::string &value) : _scalar{}
+{
+    setNode(SinType::String, makeNode<String>(std::pmr::get_default_resource(), value));
+}
+
+Sin &Sin::operator=(const std::string &value)
 {
-    if (_type == "Object")
+    setNode(SinType::String, makeNode<String>(std::pmr::get_default_resource(), value));
+    return *this;
+}
+
+std::string Sin::asString() const
+{
+    if (_type != SinType::String)
     {
-        return objectToString(pads);
+        typeAssertion("String", _type);
     }
+    return std::string(static_cast<String *>(_value.get())->value);
+}
 
-    if (_type == "Array")
+std::string_view Sin::asStringView() const
+{
+    if (_type != SinType::String)
     {
-        return arrayToString(pads);
+        typeAssertion("String", _type);
     }
+    return static_cast<String *>(_value.get())->value;
+}
 
-    if (_type == "String")
+std::string Sin::toString(const SinFormat &format) const
+{
+    std::string result;
+    toString(result, format);
+    return result;
+}
+
+void Sin::toString(std::string &out, const SinFormat &format) const
+{
+    SinWriter writer(out, format);
+    serialize(writer, 0);
+}
+
+static void writeTokenEnd(SinWriter &writer, const Sin &value)
+{
+    if (value.typeId() != SinType::String && value.typeId() != SinType::Array && value.typeId() != SinType::Object)
     {
-        return stringToString();
+        writer.endToken();
     }
+}
 
-    return numberToString(pads);
+void Sin::serialize(SinWriter &writer) const
+{
+    serialize(writer, 0);
 }
 
-std::string Sin::toString()
+void Sin::serialize(SinWriter &writer, int pads) const
 {
-    return this->_toString();
+    switch (_type)
+    {
+    case SinType::Object:
+        writeObject(writer, pads);
+        break;
+    case SinType::Array:
+        writeArray(writer, pads);
+        break;
+    case SinType::String:
+        writeString(writer);
+        break;
+    case SinType::Undefined:
+        // nothing to write, containers leave such entries out altogether
+        break;
+    default:
+        writeNumber(writer, pads);
+    }
 }
 
-const int PAD_SIZE = 2;
-const char PAD_CHAR = ' ';
+/**
+ * Shortest representation that parses back to the same value
+ */
+template <class T>
+static std::string_view formatNumber(char (&buffer)[32], T value)
+{
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    return std::string_view(buffer, end - buffer);
+}
+
+/**
+ * A scalar after its key, with the type name unless the parser can tell
+ * the type from the value alone
+ */
+static void writeScalar(SinWriter &writer, int pads, SinType type, std::string_view value, bool typed)
+{
+    writer.writeColon();
+    if (typed)
+    {
+        writer.write(sinTypeName(type));
+        if (writer.format().compact)
+        {
+            writer.put(' ');
+        }
+        writer.newline();
+        writer.indent(pads);
+    }
+    writer.write(value);
+    writer.newline();
+}
 
-static std::string getPadStr(int pads)
+template <class T>
+static void writeNumberValue(SinWriter &writer, int pads, T number)
 {
-    std::string padStr = "";
+    char buffer[32];
+    std::string_view value = formatNumber(buffer, number);
+    bool typed = true;
 
-    for (int i = 0; i < pads * PAD_SIZE; i++)
+    if constexpr (std::is_same_v<T, int32_t>)
     {
-        padStr += PAD_CHAR;
+        typed = false;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        // untyped numbers without '.' or an exponent are read back as integers,
+        // inf and nan are not numbers to the parser at all
+        if (std::isfinite(number))
+        {
+            if (value.find_first_of(".e") == std::string_view::npos)
+            {
+                buffer[value.size()] = '.';
+                buffer[value.size() + 1] = '0';
+                value = std::string_view(buffer, value.size() + 2);
+            }
+            typed = false;
+        }
     }
 
-    return padStr;
+    writeScalar(writer, pads, sinNumberType<T>(), value, typed);
 }
 
-std::string Sin::numberToString(int pads)
+void Sin::writeNumber(SinWriter &writer, int pads) const
 {
+    bool scalar = visitSinScalar(_type, _scalar, [&](auto value)
+                                 {
+                                     if constexpr (std::is_same_v<decltype(value), bool>)
+                                     {
+                                         writeScalar(writer, pads, SinType::Bool, value ? "true" : "false", false);
+                                     }
+                                     else
+                                     {
+                                         writeNumberValue(writer, pads, value);
+                                     } });
+    if (!scalar)
+    {
+        writeScalar(writer, pads, _type, {}, true);
+    }
+}
 
-#define NUMBER_CASE(SIN_TYPE) \
-    .Case(#SIN_TYPE, [&]() -> void { strValue = std::to_string(as##SIN_TYPE()); })
+/**
+ * The entries of a packed array, the element type is known for the whole loop
+ */
+template <class T>
+static void writePackedEntries(SinWriter &writer, int pads, const std::pmr::vector<T> &values, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        writer.writeIndex(pads + 1, i);
+        writeNumberValue(writer, pads + 1, values[i]);
+        writer.endToken();
+    }
+}
 
-    std::string strValue;
+void Sin::writeString(SinWriter &writer) const
+{
+    writer.writeColon();
+    writer.put('"');
+    writer.writeEscaped(static_cast<String *>(_value.get())->value);
+    writer.put('"');
+    writer.newline();
+}
 
-    Switch<std::string>(_type)
-        NUMBER_CASE(Uint8)
-            NUMBER_CASE(Int8)
-                NUMBER_CASE(Uint16)
-                    NUMBER_CASE(Int16)
-                        NUMBER_CASE(Uint32)
-                            NUMBER_CASE(Int32)
-                                NUMBER_CASE(Uint64)
-                                    NUMBER_CASE(Int64)
-                                        NUMBER_CASE(Float)
-                                            NUMBER_CASE(Double)
-                                                .Case("Bool", [&]() -> void
-                                                      { strValue = asBool() ? "true" : "false"; })
-                                                .exec();
+void Sin::writeArray(SinWriter &writer, int pads) const
+{
+    writer.writeColon();
+    writer.put('[');
+    writer.newline();
 
-    auto padStr = getPadStr(pads);
+    writeArrayEntries(writer, pads, 0, arraySize());
 
-    std::string result;
+    writer.indent(pads);
+    writer.put(']');
+    writer.newline();
+}
 
-    if (_type == "Double" || _type == "Int32" || _type == "Bool")
+void Sin::writeArrayEntries(SinWriter &writer, int pads, size_t begin, size_t end) const
+{
+    if (_packed)
     {
-        result = ": " + strValue + "\n";
+        withSinNumberType(packedNode()->element, [&](auto number)
+                       { writePackedEntries(writer, pads, static_cast<const TPacked<decltype(number)> *>(packedNode())->value, begin, end); });
+        return;
     }
-    else
+
+    const auto &array = static_cast<TArray *>(_value.get())->value;
+
+    for (size_t i = begin; i < end; i++)
     {
-        result = ": " + _type + "\n" + padStr + strValue + "\n";
+        // holes keep their place through the explicit indexes
+        if (array[i]._type == SinType::Undefined)
+        {
+            continue;
+        }
+        writer.writeIndex(pads + 1, i);
+        array[i].serialize(writer, pads + 1);
+        writeTokenEnd(writer, array[i]);
     }
+}
 
-    return result;
+void Sin::writeObject(SinWriter &writer, int pads) const
+{
+    const auto &object = asObject();
+
+    writer.writeColon();
+    writer.put('{');
+    writer.newline();
+
+    writeObjectEntries(writer, pads, object.begin(), object.end());
+
+    writer.indent(pads);
+    writer.put('}');
+    writer.newline();
 }
 
-static std::string escapeString(std::string input)
+void Sin::writeObjectEntries(SinWriter &writer, int pads, SinObject::const_iterator begin, SinObject::const_iterator end) const
 {
-    std::string result;
-    result.reserve(static_cast<size_t>(input.size() * 1.6));
+    for (auto it = begin; it != end; ++it)
+    {
+        const auto &[key, value] = *it;
+        if (value._type == SinType::Undefined)
+        {
+            continue;
+        }
+        writer.writeKey(pads + 1, key);
+        value.serialize(writer, pads + 1);
+        writeTokenEnd(writer, value);
+    }
+}
 
-    for (int i = 0; i < input.size(); i++)
+std::string Sin::toStringParallel(unsigned threads, const SinFormat &format) const
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    size_t count = 0;
+    if (_type == SinType::Array)
+    {
+        count = arraySize();
+    }
+    else if (_type == SinType::Object)
+    {
+        count = asObject().size();
+    }
+    if (threads == 1 || count < 2)
     {
-        switch (input[i])
+        return toString(format);
+    }
+
+    // a few runs per thread so that threads that finish early take more
+    size_t runs = std::min<size_t>(count, size_t(threads) * 4);
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t i = 0; i <= runs; i++)
+    {
+        bounds[i] = count * i / runs;
+    }
+
+    std::vector<SinObject::const_iterator> members;
+    if (_type == SinType::Object)
+    {
+        const auto &object = asObject();
+        auto it = object.begin();
+        for (size_t i = 0; i <= runs; i++)
         {
-        case '\t':
-            result += "\\t";
-            break;
-        case '\n':
-            result += "\\n";
-            break;
-        case '\r':
-            result += "\\r";
-            break;
-        case '"':
-            result += "\\\"";
-            break;
-        case '\\':
-            result += "\\\\";
-            break;
-        default:
-            result += input[i];
+            members.push_back(it);
+            if (i < runs)
+            {
+                it = std::next(it, bounds[i + 1] - bounds[i]);
+            }
         }
     }
 
+    std::vector<std::string> parts(runs);
+    std::atomic<size_t> next{0};
+    auto work = [&]
+    {
+        for (size_t run; (run = next++) < runs;)
+        {
+            SinWriter writer(parts[run], format);
+            if (_type == SinType::Array)
+            {
+                writeArrayEntries(writer, 0, bounds[run], bounds[run + 1]);
+            }
+            else
+            {
+                writeObjectEntries(writer, 0, members[run], members[run + 1]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < std::min<size_t>(threads, runs); i++)
+    {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    size_t size = 8;
+    for (const auto &part : parts)
+    {
+        size += part.size();
+    }
+
+    std::string result;
+    result.reserve(size);
+    SinWriter writer(result, format);
+    writer.writeColon();
+    writer.put(_type == SinType::Array ? '[' : '{');
+    writer.newline();
+    for (const auto &part : parts)
+    {
+        writer.write(part);
+    }
+    writer.indent(0);
+    writer.put(_type == SinType::Array ? ']' : '}');
+    writer.newline();
     return result;
 }
 
-std::string Sin::stringToString()
+std::string Sin::type()
 {
-    std::string input = asString();
-
-    return ": \"" + escapeString(input) + "\"\n";
+    return sinTypeName(_type);
 }
 
-std::string Sin::arrayToString(int pads)
+SinType Sin::typeId() const
 {
-    std::string result = ": [\n";
-    auto v = asArray();
+    return _type;
+}
 
-    auto padStr = getPadStr(pads + 1);
+SinArray &Sin::asArray()
+{
+    if (_type != SinType::Array)
+    {
+        typeAssertion("Array", _type);
+    }
+    detach();
+    return static_cast<TArray *>(_value.get())->value;
+}
 
-    for (int i = 0; i < v.size(); i++)
+const SinArray &Sin::asArray() const
+{
+    if (_type != SinType::Array)
     {
-        result += padStr + "[" + std::to_string(i) + "]" + v[i]._toString(pads + 1);
+        typeAssertion("Array", _type);
     }
+    if (_packed)
+    {
+        // there are no Sin elements to refer to, and making them here would
+        // allocate behind a const accessor
+        typeAssertion("unpacked Array, read packed ones with at()", _type);
+    }
+    return static_cast<const TArray *>(_value.get())->value;
+}
 
-    result += padStr.substr(0, pads * PAD_SIZE) + "]\n";
+size_t Sin::size() const
+{
+    if (_type == SinType::Object)
+    {
+        return asObject().size();
+    }
+    if (_type != SinType::Array)
+    {
+        typeAssertion("Array or Object", _type);
+    }
+    return arraySize();
+}
 
-    return result;
+Sin Sin::at(size_t index) const
+{
+    if (_type != SinType::Array)
+    {
+        typeAssertion("Array", _type);
+    }
+    if (index >= arraySize())
+    {
+        throw std::out_of_range("Array index " + std::to_string(index) + " out of range");
+    }
+    if (!_packed)
+    {
+        return static_cast<const TArray *>(_value.get())->value[index];
+    }
+    Sin element;
+    withSinNumberType(packedNode()->element, [&](auto number)
+                   { element = Sin(static_cast<const TPacked<decltype(number)> *>(packedNode())->value[index]); });
+    return element;
 }
 
-std::string Sin::objectToString(int pads)
+bool Sin::pack()
 {
-    std::string result = ": {\n";
-    auto object = asObject();
+    if (_type != SinType::Array || _packed)
+    {
+        return _packed;
+    }
 
-    auto padStr = getPadStr(pads + 1);
+    const auto &array = static_cast<TArray *>(_value.get())->value;
+    if (array.empty())
+    {
+        return false;
+    }
+    const SinType element = array[0]._type;
+    for (const auto &value : array)
+    {
+        if (value._type != element)
+        {
+            return false;
+        }
+    }
 
-    for (auto el : object)
+    std::shared_ptr<SinValue> node;
+    withSinNumberType(element, [&](auto number)
+                   {
+                       using T = decltype(number);
+                       auto packed = makeNode<TPacked<T>>(array.get_allocator().resource());
+                       packed->value.reserve(array.size());
+                       for (const auto &value : array)
+                       {
+                           std::memcpy(&number, &value._scalar, sizeof(T));
+                           packed->value.push_back(number);
+                       }
+                       node = std::move(packed); });
+    if (!node)
     {
-        auto key = (el.first.find(' ') == std::string::npos ? ("." + el.first) : ("[\"" + escapeString(el.first) + "\"]"));
-        result += padStr + key + el.second._toString(pads + 1);
+        // Bool, String and container elements stay as they are
+        return false;
     }
+    setNode(SinType::Array, std::move(node));
+    _packed = true;
+    return true;
+}
 
-    result += padStr.substr(0, pads * PAD_SIZE) + "}\n";
-    return result;
+/**
+ * Replaces a packed node by a regular TArray with the same elements
+ */
+void Sin::unpack()
+{
+    auto *packed = static_cast<TPackedArray *>(_value.get());
+    auto array = makeNode<TArray>(std::pmr::get_default_resource());
+    withSinNumberType(packed->element, [&](auto number)
+                   {
+                       using T = decltype(number);
+                       const auto &values = static_cast<TPacked<T> *>(packed)->value;
+                       array->value.reserve(values.size());
+                       for (T value : values)
+                       {
+                           array->value.emplace_back(value);
+                       } });
+    setNode(SinType::Array, std::move(array));
 }
 
-std::string Sin::type()
+const TPackedArray *Sin::packedNode() const
 {
-    return _type;
+    return _packed ? static_cast<const TPackedArray *>(_value.get()) : nullptr;
 }
 
-std::vector<Sin> &Sin::asArray()
+SinType Sin::packedType() const
 {
-    if (_type != "Array")
+    return _packed ? packedNode()->element : SinType::Undefined;
+}
+
+size_t Sin::arraySize() const
+{
+    if (!_packed)
     {
-        std::cout << "Type assertion. Requested type: Array, Actual type: " + _type << std::endl
-                  << std::endl;
-        throw "Type assertion. Requested type: Array, Actual type: " + _type;
+        return static_cast<TArray *>(_value.get())->value.size();
     }
-    return dynamic_cast<TArray *>(_value.get())->value;
+    size_t size = 0;
+    withSinNumberType(packedNode()->element, [&](auto number)
+                   { size = static_cast<const TPacked<decltype(number)> *>(packedNode())->value.size(); });
+    return size;
 }
 
-std::map<std::string, Sin> &Sin::asObject()
+template <class T>
+std::span<const T> Sin::asSpan() const
 {
-    if (_type != "Object")
+    if (!_packed || packedNode()->element != sinNumberType<T>())
     {
-        std::cout << "Type assertion. Requested type: Object, Actual type: " + _type << std::endl
-                  << std::endl;
-        throw "Type assertion. Requested type: Object, Actual type: " + _type;
+        typeAssertion((std::string("packed Array of ") + sinTypeName(sinNumberType<T>())).c_str(), _type);
     }
-    return dynamic_cast<TObject *>(_value.get())->value;
+    const auto &values = static_cast<const TPacked<T> *>(packedNode())->value;
+    return std::span<const T>(values.data(), values.size());
 }
 
-Sin &Sin::operator[](const int index)
+template std::span<const uint8_t> Sin::asSpan<uint8_t>() const;
+template std::span<const int8_t> Sin::asSpan<int8_t>() const;
+template std::span<const uint16_t> Sin::asSpan<uint16_t>() const;
+template std::span<const int16_t> Sin::asSpan<int16_t>() const;
+template std::span<const uint32_t> Sin::asSpan<uint32_t>() const;
+template std::span<const int32_t> Sin::asSpan<int32_t>() const;
+template std::span<const uint64_t> Sin::asSpan<uint64_t>() const;
+template std::span<const int64_t> Sin::asSpan<int64_t>() const;
+template std::span<const float> Sin::asSpan<float>() const;
+template std::span<const double> Sin::asSpan<double>() const;
+
+SinObject &Sin::asObject()
 {
-    if (_type != "Array")
+    if (_type != SinType::Object)
     {
-        _type = "Array";
-        _value = std::make_shared<TArray>();
-
-        auto v = dynamic_cast<TArray *>(_value.get());
+        typeAssertion("Object", _type);
+    }
+    detach();
+    return static_cast<TObject *>(_value.get())->value;
+}
 
-        for (int i = 0; i <= index; i++)
-        {
-            v->value.push_back(Sin{});
-        }
+const SinObject &Sin::asObject() const
+{
+    if (_type != SinType::Object)
+    {
+        typeAssertion("Object", _type);
     }
-    else if (int(asArray().size()) - 1 < index)
+    if (!_value)
     {
-        auto left = index - (asArray().size() - 1);
-        for (int i = 0; i < left; i++)
-        {
-            asArray().push_back(Sin{});
-        }
+        static const SinObject empty;
+        return empty;
+    }
+    return static_cast<const TObject *>(_value.get())->value;
+}
+
+Sin &Sin::operator[](const int index)
+{
+    if (_type != SinType::Array)
+    {
+        setNode(SinType::Array, makeNode<TArray>(std::pmr::get_default_resource()));
     }
+    detach();
 
-    return dynamic_cast<TArray *>(_value.get())->value[index];
+    auto &array = static_cast<TArray *>(_value.get())->value;
+    if (array.size() <= size_t(index))
+    {
+        array.resize(size_t(index) + 1, Undefined());
+    }
+    return array[index];
 }
 
-Sin &Sin::operator[](const std::string &key)
+Sin &Sin::operator[](std::string_view key)
 {
+    if (_type != SinType::Object)
+    {
+        setNode(SinType::Object, makeNode<TObject>(std::pmr::get_default_resource()));
+    }
+    detach();
 
-    if (_type != "Object")
+    return static_cast<TObject *>(_value.get())->value[key];
+}
+
+Sin &Sin::emplace(std::string_view key, Sin value)
+{
+    if (_type != SinType::Object)
     {
-        _type = "Object";
-        _value = std::make_shared<TObject>();
+        setNode(SinType::Object, nullptr);
     }
+    detach();
 
-    auto v = dynamic_cast<TObject *>(_value.get())->value;
+    return static_cast<TObject *>(_value.get())->value.try_emplace(key, std::move(value)).first->second;
+}
 
-    if (!v.contains(key))
+Sin &Sin::push_back(Sin value)
+{
+    if (_type != SinType::Array)
     {
-        v[key] = Sin{};
+        setNode(SinType::Array, makeNode<TArray>(std::pmr::get_default_resource()));
     }
+    detach();
 
-    return dynamic_cast<TObject *>(_value.get())->value[key];
+    return static_cast<TArray *>(_value.get())->value.emplace_back(std::move(value));
+}
+
+Sin Sin::Undefined()
+{
+    Sin sin;
+    sin.release();
+    return sin;
 }
 
-Sin Sin::Array()
+Sin Sin::Array(std::pmr::memory_resource *resource)
 {
-    return Sin({});
+    return Sin(SinType::Array, makeNode<TArray>(resource));
 }
 
-Sin Sin::Object()
+Sin Sin::Object(std::pmr::memory_resource *resource)
 {
-    return Sin{};
+    return Sin(SinType::Object, makeNode<TObject>(resource));
 }
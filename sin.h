@@ -1,35 +1,97 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
 #include <initializer_list>
+#include <optional>
+#include <span>
 
+#include "sin_arena.h"
 #include "sin_value.h"
-#include "switch.h"
+#include "sin_writer.h"
 
 #define SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(SIN_TYPE, STANDARD_TYPE) \
     Sin(const STANDARD_TYPE &value);                                    \
-    void operator=(STANDARD_TYPE &value);                               \
+    Sin &operator=(const STANDARD_TYPE &value);                         \
     STANDARD_TYPE as##SIN_TYPE() const;
 
+/**
+ * A SIN value. Copies are cheap and independent: strings, arrays and
+ * objects are shared between copies until one of them is changed through
+ * a non-const accessor, which first gives that copy its own node. Only
+ * the nodes on the path to a change are copied, their children stay shared.
+ *
+ * References returned by non-const accessors are to the value's own node
+ * and must not be used after the value has been copied.
+ */
 class Sin
 {
-    std::shared_ptr<SinValue> _value;
-    std::string _type;
+    SinType _type = SinType::Undefined;
+    // an Array whose node is a TPackedArray
+    bool _packed = false;
 
-    std::string _toString(int pads = 0);
+    /**
+     * Scalars live inline, _value is only alive for String, Array and Object
+     */
+    union
+    {
+        SinScalar _scalar;
+        std::shared_ptr<SinValue> _value;
+    };
+
+    Sin(SinType type, std::shared_ptr<SinValue> node);
+
+    static bool hasNode(SinType type);
+    void setNode(SinType type, std::shared_ptr<SinValue> node);
+    void release();
+    void detach();
+    void unpack();
+    static void typeMismatch(const char *requested, SinType actual);
+
+    /**
+     * Calls f with the value converted to T if its type widens to T
+     */
+    template <class T, class F>
+    bool withWidened(F &&f) const;
+    const TPackedArray *packedNode() const;
+    size_t arraySize() const;
 
 public:
     Sin();
     Sin(const char *str);
     Sin(std::initializer_list<Sin> list);
 
-    static Sin parse(const std::string &str);
+    /**
+     * String value with its characters allocated from the given resource
+     */
+    Sin(std::string_view str, std::pmr::memory_resource *resource);
+
+    Sin(const Sin &other);
+    Sin(Sin &&other) noexcept;
+    Sin &operator=(const Sin &other);
+    Sin &operator=(Sin &&other) noexcept;
+    Sin &operator=(const char *str);
+
+    /**
+     * An Array of the elements, `sin = {}` makes an empty Object like Sin() does
+     */
+    Sin &operator=(std::initializer_list<Sin> list);
+    ~Sin();
+
+    static Sin parse(std::string_view str);
+
+    /**
+     * Parses the whole tree into the arena, see SinArena
+     */
+    static Sin parse(std::string_view str, SinArena &arena);
 
     std::string type();
 
+    SinType typeId() const;
+
     SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(Uint8, uint8_t);
     SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(Int8, int8_t);
     SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(Uint16, uint16_t);
@@ -43,23 +105,223 @@ public:
     SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(String, std::string);
     SIN_DEFINE_STANDARD_TYPE_SETTER_GETTER(Bool, bool);
 
-    std::vector<Sin> &asArray();
+    /**
+     * Characters of a String without copying them
+     */
+    std::string_view asStringView() const;
+
+    /**
+     * The value as T: one of the number types, bool, std::string or
+     * std::string_view. Numbers are also read as any type that holds all
+     * values of their own type exactly, so an Int8 can be read as int64_t
+     * and a Uint16 as double, but an Int64 can't be read as int32_t. Throws
+     * like the as* getters otherwise.
+     */
+    template <class T>
+    T get() const;
+
+    /**
+     * The value as T like get<T>(), nullopt instead of throwing
+     */
+    template <class T>
+    std::optional<T> try_get() const;
+
+    /**
+     * Whether get<T>() would succeed
+     */
+    template <class T>
+    bool is() const;
+
+    /**
+     * A packed Array becomes a regular one when it is changed through the
+     * non-const overload. The const overload throws for a packed Array, its
+     * elements are read with size() and at(), or with asSpan<T>() for the T
+     * that packedType() names.
+     */
+    SinArray &asArray();
+    const SinArray &asArray() const;
+
+    /**
+     * Number of elements of an Array, packed or not, or members of an Object
+     */
+    size_t size() const;
+
+    /**
+     * Element of an Array, packed or not, by value. Throws std::out_of_range
+     * past the end.
+     */
+    Sin at(size_t index) const;
+
+    /**
+     * Stores an Array whose elements are all numbers of one type as one
+     * contiguous buffer, returns whether it is packed. Parsed arrays of
+     * SinTreeBuilder::PACK_MIN elements or more are packed already.
+     */
+    bool pack();
+
+    /**
+     * The elements of an Array packed with elements of type T, without
+     * copying them. Throws like the as* getters for anything else.
+     */
+    template <class T>
+    std::span<const T> asSpan() const;
+
+    /**
+     * The element type of a packed Array, Undefined for any other value
+     */
+    SinType packedType() const;
 
-    std::map<std::string, Sin> &asObject();
+    SinObject &asObject();
+    const SinObject &asObject() const;
 
     Sin &operator[](const int index);
 
-    Sin &operator[](const std::string &key);
+    Sin &operator[](std::string_view key);
 
-    std::string toString();
+    /**
+     * Adds key with value unless the object has it already, and returns the
+     * key's value. Like operator[], turns a value that is not an Object into one.
+     */
+    Sin &emplace(std::string_view key, Sin value);
 
-    static Sin Array();
+    /**
+     * Appends to an Array, a value that is not an Array becomes an empty one first
+     */
+    Sin &push_back(Sin value);
 
-    static Sin Object();
+    std::string toString(const SinFormat &format = {}) const;
+
+    /**
+     * Appends the text form to out, see serialize
+     */
+    void toString(std::string &out, const SinFormat &format = {}) const;
+
+    /**
+     * Same text as toString, with the entries of a root Array or Object
+     * written on `threads` threads, 0 uses one per core. Each thread writes
+     * a run of entries into its own buffer and the buffers are joined in
+     * order. The tree must not be modified while this runs.
+     */
+    std::string toStringParallel(unsigned threads = 0, const SinFormat &format = {}) const;
+
+    /**
+     * Writes the text form without building intermediate strings. Large
+     * snapshots can go straight to a file with SinWriter(std::ostream&).
+     */
+    void serialize(SinWriter &writer) const;
+
+    /**
+     * Writes the value as the value of an entry at nesting level pads,
+     * from the ':' after its key or index on. For encoders that write the
+     * keys themselves, like the ones SIN_BIND makes.
+     */
+    void serialize(SinWriter &writer, int pads) const;
+
+    static Sin Array(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /**
+     * A value that holds nothing, it doesn't allocate. Arrays are padded
+     * with it up to an index past their end, and serialization leaves such
+     * holes out, the indexes of the other elements keep their places.
+     */
+    static Sin Undefined();
+
+    static Sin Object(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
 private:
-    std::string numberToString(int pads = 0);
-    std::string stringToString();
-    std::string arrayToString(int pads = 0);
-    std::string objectToString(int pads = 0);
+    void writeNumber(SinWriter &writer, int pads) const;
+    void writeString(SinWriter &writer) const;
+    void writeArray(SinWriter &writer, int pads) const;
+    void writeArrayEntries(SinWriter &writer, int pads, size_t begin, size_t end) const;
+    void writeObject(SinWriter &writer, int pads) const;
+    void writeObjectEntries(SinWriter &writer, int pads, SinObject::const_iterator begin, SinObject::const_iterator end) const;
 };
+
+template <class T, class F>
+bool Sin::withWidened(F &&f) const
+{
+    bool widened = false;
+    withSinNumberType(_type, [&](auto zero)
+                      {
+                          using From = decltype(zero);
+                          if constexpr (sinWidens<From, T>())
+                          {
+                              f(static_cast<T>(_scalar.*sinScalarMember<From>()));
+                              widened = true;
+                          } });
+    return widened;
+}
+
+template <class T>
+std::optional<T> Sin::try_get() const
+{
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+    {
+        if (_type != SinType::String)
+        {
+            return std::nullopt;
+        }
+        return T(asStringView());
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        if (_type != SinType::Bool)
+        {
+            return std::nullopt;
+        }
+        return _scalar.Bool;
+    }
+    else
+    {
+        static_assert(sinNumberType<T>() != SinType::Undefined, "get<T> reads numbers, bool, std::string and std::string_view");
+
+        // the stored type is one compare and a load
+        if (_type == sinNumberType<T>())
+        {
+            return _scalar.*sinScalarMember<T>();
+        }
+        std::optional<T> value;
+        withWidened<T>([&value](T widened)
+                       { value = widened; });
+        return value;
+    }
+}
+
+template <class T>
+T Sin::get() const
+{
+    if (auto value = try_get<T>())
+    {
+        return *std::move(value);
+    }
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+    {
+        typeMismatch("String", _type);
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        typeMismatch("Bool", _type);
+    }
+    else
+    {
+        typeMismatch(sinTypeName(sinNumberType<T>()), _type);
+    }
+    return T{};
+}
+
+template <class T>
+bool Sin::is() const
+{
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+    {
+        return _type == SinType::String;
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return _type == SinType::Bool;
+    }
+    else
+    {
+        return _type == sinNumberType<T>() || withWidened<T>([](T) {});
+    }
+}
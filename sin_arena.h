@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * Monotonic memory for parsed documents.
+ *
+ * Sin::parse(str, arena) takes every node, container and string of the
+ * parsed tree from the arena. Object keys are the exception: they are
+ * interned in the process wide SinKey pool and shared with every other
+ * document that uses them. Freeing a node is a no-op and the memory is
+ * given back all at once when the arena is destroyed, so tearing down a
+ * large document does no per-node deallocation.
+ *
+ * The arena must outlive every Sin that refers to its nodes. Values made
+ * later with the regular Sin API are allocated normally, and so are the
+ * copies a change makes of shared nodes, so copies of a parsed document
+ * can be patched from several threads.
+ *
+ * Inserting into a container of the parsed tree that isn't shared does
+ * grow it from the arena, though: its element vector or object member
+ * comes from the container's resource, and the buffer a growing vector
+ * leaves behind is not reused until the arena is destroyed. To edit a
+ * document heavily, keep the parsed Sin and edit a copy of it: the
+ * containers the copy changes detach into the default resource. Only one
+ * thread at a time may change the parsed tree itself.
+ */
+class SinArena
+{
+    std::pmr::monotonic_buffer_resource _resource;
+
+public:
+    explicit SinArena(size_t initialSize = 64 * 1024) : _resource{initialSize} {}
+
+    SinArena(const SinArena &) = delete;
+    SinArena &operator=(const SinArena &) = delete;
+
+    std::pmr::memory_resource *resource()
+    {
+        return &_resource;
+    }
+};
@@ -0,0 +1,504 @@
+#include "sin_binary.h"
+#include "sin_parser.h"
+#include "sin_sax.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr char MAGIC[4] = {'S', 'I', 'N', 'B'};
+static constexpr uint32_t HEADER_SIZE = 8;
+
+template <class T>
+static void storeAt(char *data, T value)
+{
+    std::memcpy(data, &value, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        std::reverse(data, data + sizeof(T));
+    }
+}
+
+template <class T>
+static void store(std::string &out, T value)
+{
+    out.append(sizeof(T), '\0');
+    storeAt(out.data() + out.size() - sizeof(T), value);
+}
+
+template <class T>
+static T load(const char *data)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, data, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+static uint32_t checkedOffset(size_t offset)
+{
+    if (offset > UINT32_MAX)
+    {
+        throw std::length_error("SIN binary data is limited to 4 GiB");
+    }
+    return static_cast<uint32_t>(offset);
+}
+
+static void encodeString(std::string &out, std::string_view str)
+{
+    store(out, checkedOffset(str.size()));
+    out.append(str);
+}
+
+/**
+ * The same layout as an array of the scalars, written from the packed buffer
+ */
+template <class T>
+static void encodePacked(std::span<const T> values, std::string &out)
+{
+    store(out, checkedOffset(values.size()));
+    size_t table = out.size();
+    out.append(values.size() * 4, '\0');
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        storeAt(out.data() + table + i * 4, checkedOffset(out.size()));
+        out.push_back(static_cast<char>(sinNumberType<T>()));
+        store(out, values[i]);
+    }
+}
+
+static void encode(const Sin &sin, std::string &out)
+{
+    const SinType type = sin.typeId();
+    out.push_back(static_cast<char>(type));
+
+    if (sin.packedType() != SinType::Undefined)
+    {
+        withSinNumberType(sin.packedType(), [&](auto zero)
+                          { encodePacked(sin.asSpan<decltype(zero)>(), out); });
+        return;
+    }
+
+    switch (type)
+    {
+    case SinType::Bool:
+        out.push_back(sin.asBool() ? 1 : 0);
+        break;
+    case SinType::String:
+        encodeString(out, sin.asStringView());
+        break;
+    case SinType::Array:
+    {
+        const auto &array = sin.asArray();
+        store(out, checkedOffset(array.size()));
+        size_t table = out.size();
+        out.append(array.size() * 4, '\0');
+        for (size_t i = 0; i < array.size(); i++)
+        {
+            storeAt(out.data() + table + i * 4, checkedOffset(out.size()));
+            encode(array[i], out);
+        }
+        break;
+    }
+    case SinType::Object:
+    {
+        // SinObject iterates in key order, which is what the reader searches by
+        const auto &object = sin.asObject();
+        store(out, checkedOffset(object.size()));
+        size_t table = out.size();
+        out.append(object.size() * 8, '\0');
+        size_t i = 0;
+        for (const auto &[key, value] : object)
+        {
+            storeAt(out.data() + table + i * 8, checkedOffset(out.size()));
+            encodeString(out, key);
+            storeAt(out.data() + table + i * 8 + 4, checkedOffset(out.size()));
+            encode(value, out);
+            i++;
+        }
+        break;
+    }
+    default:
+        withSinNumberType(type, [&](auto zero)
+                          { store(out, sin.get<decltype(zero)>()); });
+        break;
+    }
+}
+
+void sinToBinary(const Sin &sin, std::string &out)
+{
+    size_t start = out.size();
+    out.append(MAGIC, sizeof(MAGIC));
+    store(out, SIN_BINARY_VERSION);
+    encode(sin, out);
+    checkedOffset(out.size() - start);
+}
+
+std::string sinToBinary(const Sin &sin)
+{
+    std::string out;
+    sinToBinary(sin, out);
+    return out;
+}
+
+std::string sinTextToBinary(std::string_view text)
+{
+    return sinToBinary(parseSin(text));
+}
+
+std::string sinBinaryToText(std::string_view data, const SinFormat &format)
+{
+    return SinBinaryView::root(data).toSin().toString(format);
+}
+
+[[noreturn]] static void malformed(const char *what)
+{
+    throw std::invalid_argument(std::string("Invalid SIN binary data: ") + what);
+}
+
+static void typeAssertion(const char *requested, SinType actual)
+{
+    throw std::string("Type assertion. Requested type: ") + requested + ", Actual type: " + sinTypeName(actual);
+}
+
+SinBinaryView::SinBinaryView(std::string_view data, uint32_t offset) : _data{data}, _offset{offset}
+{
+    if (_offset >= _data.size())
+    {
+        malformed("value offset out of bounds");
+    }
+    if (static_cast<uint8_t>(_data[_offset]) > static_cast<uint8_t>(SinType::Object))
+    {
+        malformed("unknown type");
+    }
+}
+
+SinBinaryView SinBinaryView::root(std::string_view data)
+{
+    if (data.size() <= HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+    {
+        malformed("missing header");
+    }
+    if (load<uint32_t>(data.data() + 4) != SIN_BINARY_VERSION)
+    {
+        malformed("unsupported version");
+    }
+    if (data.size() > UINT32_MAX)
+    {
+        malformed("data larger than 4 GiB");
+    }
+    return SinBinaryView(data, HEADER_SIZE);
+}
+
+SinType SinBinaryView::typeId() const
+{
+    return static_cast<SinType>(_data[_offset]);
+}
+
+std::string SinBinaryView::type() const
+{
+    return sinTypeName(typeId());
+}
+
+/**
+ * Offset of the payload after the type byte
+ */
+uint32_t SinBinaryView::payload() const
+{
+    return _offset + 1;
+}
+
+#define SIN_BINARY_SCALAR_GETTER(SIN_TYPE, STANDARD_TYPE)               \
+    STANDARD_TYPE SinBinaryView::as##SIN_TYPE() const                   \
+    {                                                                   \
+        if (typeId() != SinType::SIN_TYPE)                              \
+        {                                                               \
+            typeAssertion(#SIN_TYPE, typeId());                         \
+        }                                                               \
+        if (size_t(payload()) + sizeof(STANDARD_TYPE) > _data.size())   \
+        {                                                               \
+            malformed("truncated value");                               \
+        }                                                               \
+        return load<STANDARD_TYPE>(_data.data() + payload());           \
+    }
+
+SIN_BINARY_SCALAR_GETTER(Uint8, uint8_t)
+SIN_BINARY_SCALAR_GETTER(Int8, int8_t)
+SIN_BINARY_SCALAR_GETTER(Uint16, uint16_t)
+SIN_BINARY_SCALAR_GETTER(Int16, int16_t)
+SIN_BINARY_SCALAR_GETTER(Uint32, uint32_t)
+SIN_BINARY_SCALAR_GETTER(Int32, int32_t)
+SIN_BINARY_SCALAR_GETTER(Uint64, uint64_t)
+SIN_BINARY_SCALAR_GETTER(Int64, int64_t)
+SIN_BINARY_SCALAR_GETTER(Float, float)
+SIN_BINARY_SCALAR_GETTER(Double, double)
+
+bool SinBinaryView::asBool() const
+{
+    if (typeId() != SinType::Bool)
+    {
+        typeAssertion("Bool", typeId());
+    }
+    if (payload() >= _data.size())
+    {
+        malformed("truncated value");
+    }
+    return _data[payload()] != 0;
+}
+
+std::string_view SinBinaryView::stringAt(uint32_t offset) const
+{
+    if (size_t(offset) + 4 > _data.size())
+    {
+        malformed("truncated string");
+    }
+    uint32_t length = load<uint32_t>(_data.data() + offset);
+    if (size_t(offset) + 4 + length > _data.size())
+    {
+        malformed("truncated string");
+    }
+    return _data.substr(offset + 4, length);
+}
+
+std::string_view SinBinaryView::asString() const
+{
+    if (typeId() != SinType::String)
+    {
+        typeAssertion("String", typeId());
+    }
+    return stringAt(payload());
+}
+
+size_t SinBinaryView::size() const
+{
+    SinType type = typeId();
+    if (type != SinType::Array && type != SinType::Object)
+    {
+        typeAssertion("Array or Object", type);
+    }
+    if (size_t(payload()) + 4 > _data.size())
+    {
+        malformed("truncated container");
+    }
+    size_t count = load<uint32_t>(_data.data() + payload());
+    size_t entrySize = type == SinType::Array ? 4 : 8;
+    if (size_t(payload()) + 4 + count * entrySize > _data.size())
+    {
+        malformed("truncated container");
+    }
+    return count;
+}
+
+/**
+ * Field of the index-th entry of the offset table, fields are
+ * value for arrays and key, value for objects. The caller checks
+ * index against size().
+ */
+uint32_t SinBinaryView::entryOffset(size_t index, size_t field) const
+{
+    size_t entrySize = typeId() == SinType::Array ? 4 : 8;
+    uint32_t offset = load<uint32_t>(_data.data() + payload() + 4 + index * entrySize + field * 4);
+    // the encoder writes children after their container, which also rules out cycles
+    if (offset <= _offset)
+    {
+        malformed("backward offset");
+    }
+    return offset;
+}
+
+SinBinaryView SinBinaryView::operator[](size_t index) const
+{
+    if (typeId() != SinType::Array)
+    {
+        typeAssertion("Array", typeId());
+    }
+    if (index >= size())
+    {
+        throw std::out_of_range("Array index " + std::to_string(index) + " out of range");
+    }
+    return SinBinaryView(_data, entryOffset(index, 0));
+}
+
+std::string_view SinBinaryView::keyAt(size_t index) const
+{
+    if (typeId() != SinType::Object)
+    {
+        typeAssertion("Object", typeId());
+    }
+    if (index >= size())
+    {
+        throw std::out_of_range("Member index " + std::to_string(index) + " out of range");
+    }
+    return stringAt(entryOffset(index, 0));
+}
+
+SinBinaryView SinBinaryView::valueAt(size_t index) const
+{
+    if (typeId() != SinType::Object)
+    {
+        typeAssertion("Object", typeId());
+    }
+    if (index >= size())
+    {
+        throw std::out_of_range("Member index " + std::to_string(index) + " out of range");
+    }
+    return SinBinaryView(_data, entryOffset(index, 1));
+}
+
+std::optional<SinBinaryView> SinBinaryView::find(std::string_view key) const
+{
+    if (typeId() != SinType::Object)
+    {
+        typeAssertion("Object", typeId());
+    }
+
+    size_t low = 0;
+    size_t high = size();
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        int order = stringAt(entryOffset(middle, 0)).compare(key);
+        if (order == 0)
+        {
+            return SinBinaryView(_data, entryOffset(middle, 1));
+        }
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return std::nullopt;
+}
+
+SinBinaryView SinBinaryView::operator[](std::string_view key) const
+{
+    auto value = find(key);
+    if (!value)
+    {
+        throw std::out_of_range("No member '" + std::string(key) + "'");
+    }
+    return *value;
+}
+
+Sin SinBinaryView::toSin(std::pmr::memory_resource *resource) const
+{
+#define SCALAR_TO_SIN(SIN_TYPE)  \
+    case SinType::SIN_TYPE:      \
+        return as##SIN_TYPE();
+
+    switch (typeId())
+    {
+        SCALAR_TO_SIN(Uint8)
+        SCALAR_TO_SIN(Int8)
+        SCALAR_TO_SIN(Uint16)
+        SCALAR_TO_SIN(Int16)
+        SCALAR_TO_SIN(Uint32)
+        SCALAR_TO_SIN(Int32)
+        SCALAR_TO_SIN(Uint64)
+        SCALAR_TO_SIN(Int64)
+        SCALAR_TO_SIN(Float)
+        SCALAR_TO_SIN(Double)
+        SCALAR_TO_SIN(Bool)
+    case SinType::String:
+        return Sin(asString(), resource);
+    case SinType::Array:
+    {
+        Sin sin = Sin::Array(resource);
+        auto &array = sin.asArray();
+        size_t count = size();
+        array.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            array.push_back(SinBinaryView(_data, entryOffset(i, 0)).toSin(resource));
+        }
+        SinTreeBuilder::packArray(sin);
+        return sin;
+    }
+    case SinType::Object:
+    {
+        Sin sin = Sin::Object(resource);
+        auto &object = sin.asObject();
+        size_t count = size();
+        object.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            object.appendUnsorted(stringAt(entryOffset(i, 0)), SinBinaryView(_data, entryOffset(i, 1)).toSin(resource));
+        }
+        // keys are stored sorted, this only checks them and builds the index
+        object.sortKeys();
+        return sin;
+    }
+    case SinType::Undefined:
+        return Sin::Undefined();
+    default:
+        return {};
+    }
+
+#undef SCALAR_TO_SIN
+}
+
+SinBinaryFile::SinBinaryFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Can't stat " + path);
+    }
+
+    _size = static_cast<size_t>(info.st_size);
+    if (_size > 0)
+    {
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (_data == MAP_FAILED)
+        {
+            int error = errno;
+            _data = nullptr;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Can't map " + path);
+        }
+    }
+    ::close(fd);
+}
+
+SinBinaryFile::~SinBinaryFile()
+{
+    if (_data)
+    {
+        ::munmap(_data, _size);
+    }
+}
+
+std::string_view SinBinaryFile::data() const
+{
+    return std::string_view(static_cast<const char *>(_data), _size);
+}
+
+SinBinaryView SinBinaryFile::root() const
+{
+    return SinBinaryView::root(data());
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "sin.h"
+
+/**
+ * Binary form of a Sin tree.
+ *
+ * All integers are little endian and every offset is a u32 from the start
+ * of the data:
+ *
+ *   header   "SINB" u32 version, followed by the root value
+ *   value    u8 SinType, then the payload for that type
+ *   scalars  1, 2, 4 or 8 bytes, Bool is one byte
+ *   String   u32 length, bytes
+ *   Array    u32 count, count x u32 value offset
+ *   Object   u32 count, count x (u32 key offset, u32 value offset),
+ *            sorted by key bytes; a key is u32 length, bytes
+ *
+ * Containers only hold offsets, so a reader can walk the data in place,
+ * e.g. straight from a memory mapped file, and look keys up with a binary
+ * search.
+ */
+
+constexpr uint32_t SIN_BINARY_VERSION = 1;
+
+std::string sinToBinary(const Sin &sin);
+
+/**
+ * Appends the binary form to out
+ */
+void sinToBinary(const Sin &sin, std::string &out);
+
+/**
+ * Converts between the text and the binary form, throws
+ * std::invalid_argument if either input is malformed
+ */
+std::string sinTextToBinary(std::string_view text);
+std::string sinBinaryToText(std::string_view data, const SinFormat &format = {});
+
+/**
+ * Read-only view of one value inside binary data. Does not own the data
+ * and does no allocations, every access is bounds checked and throws
+ * std::invalid_argument if the data is malformed.
+ */
+class SinBinaryView
+{
+    std::string_view _data;
+    uint32_t _offset = 0;
+
+    SinBinaryView(std::string_view data, uint32_t offset);
+
+    uint32_t payload() const;
+    uint32_t entryOffset(size_t index, size_t field) const;
+    std::string_view stringAt(uint32_t offset) const;
+
+public:
+    /**
+     * Root value of the binary data, throws std::invalid_argument
+     * if the header is missing or of another version
+     */
+    static SinBinaryView root(std::string_view data);
+
+    SinType typeId() const;
+    std::string type() const;
+
+    uint8_t asUint8() const;
+    int8_t asInt8() const;
+    uint16_t asUint16() const;
+    int16_t asInt16() const;
+    uint32_t asUint32() const;
+    int32_t asInt32() const;
+    uint64_t asUint64() const;
+    int64_t asInt64() const;
+    float asFloat() const;
+    double asDouble() const;
+    bool asBool() const;
+
+    /**
+     * Points into the data
+     */
+    std::string_view asString() const;
+
+    /**
+     * Number of elements of an Array or members of an Object
+     */
+    size_t size() const;
+
+    SinBinaryView operator[](size_t index) const;
+
+    /**
+     * Member lookup, throws std::out_of_range if the key is missing
+     */
+    SinBinaryView operator[](std::string_view key) const;
+
+    std::optional<SinBinaryView> find(std::string_view key) const;
+
+    /**
+     * Members of an Object in key order
+     */
+    std::string_view keyAt(size_t index) const;
+    SinBinaryView valueAt(size_t index) const;
+
+    /**
+     * Builds the regular tree, nodes are allocated from the resource
+     */
+    Sin toSin(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+};
+
+/**
+ * Read-only memory mapping of a file with binary SIN data
+ */
+class SinBinaryFile
+{
+    void *_data = nullptr;
+    size_t _size = 0;
+
+public:
+    /**
+     * Throws std::system_error if the file can't be mapped
+     */
+    explicit SinBinaryFile(const std::string &path);
+    ~SinBinaryFile();
+
+    SinBinaryFile(const SinBinaryFile &) = delete;
+    SinBinaryFile &operator=(const SinBinaryFile &) = delete;
+
+    std::string_view data() const;
+
+    SinBinaryView root() const;
+};
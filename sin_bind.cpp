@@ -0,0 +1,113 @@
+#include "sin_bind.h"
+
+void SinBindDecoder::bind(void *target, const SinBindOps *ops)
+{
+    _stack.clear();
+    _next = Frame{target, ops};
+    _treeDepth = 0;
+    _treeTarget = nullptr;
+    _error.clear();
+}
+
+const std::string &SinBindDecoder::error() const
+{
+    return _error;
+}
+
+/**
+ * Same message as the as* getters give
+ */
+SinSaxAction SinBindDecoder::mismatch(SinType actual)
+{
+    _error = std::string("Type assertion. Requested type: ") + sinTypeName(_next.ops->type) + ", Actual type: " + sinTypeName(actual);
+    return SinSaxAction::Stop;
+}
+
+SinSaxAction SinBindDecoder::begin(SinBindOps::Kind kind)
+{
+    if (_treeDepth > 0 || _next.ops->kind == SinBindOps::Kind::Tree)
+    {
+        if (_treeDepth++ == 0)
+        {
+            _treeTarget = static_cast<Sin *>(_next.target);
+            _tree.reset(std::pmr::get_default_resource());
+        }
+        return kind == SinBindOps::Kind::Object ? _tree.onObjectBegin() : _tree.onArrayBegin();
+    }
+
+    if (_next.ops->kind != kind)
+    {
+        return mismatch(kind == SinBindOps::Kind::Object ? SinType::Object : SinType::Array);
+    }
+    if (_next.ops->begin)
+    {
+        _next.ops->begin(_next.target);
+    }
+    _stack.push_back(_next);
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinBindDecoder::onObjectBegin()
+{
+    return begin(SinBindOps::Kind::Object);
+}
+
+SinSaxAction SinBindDecoder::onArrayBegin()
+{
+    return begin(SinBindOps::Kind::Array);
+}
+
+SinSaxAction SinBindDecoder::onKey(std::string_view key)
+{
+    if (_treeDepth > 0)
+    {
+        return _tree.onKey(key);
+    }
+    const Frame &frame = _stack.back();
+    _next.target = frame.ops->member(frame.target, key, _next.ops);
+    return _next.target ? SinSaxAction::Continue : SinSaxAction::Skip;
+}
+
+SinSaxAction SinBindDecoder::onArrayIndex(size_t index)
+{
+    if (_treeDepth > 0)
+    {
+        return _tree.onArrayIndex(index);
+    }
+    const Frame &frame = _stack.back();
+    _next.target = frame.ops->element(frame.target, index, _next.ops);
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinBindDecoder::onScalar(const SinSaxScalar &scalar)
+{
+    if (_treeDepth > 0)
+    {
+        return _tree.onScalar(scalar);
+    }
+    if (_next.ops->kind == SinBindOps::Kind::Tree)
+    {
+        *static_cast<Sin *>(_next.target) = SinTreeBuilder::toSin(scalar, std::pmr::get_default_resource());
+        return SinSaxAction::Continue;
+    }
+    if (_next.ops->kind != SinBindOps::Kind::Scalar || !_next.ops->scalar(_next.target, scalar))
+    {
+        return mismatch(scalar.type);
+    }
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinBindDecoder::onEnd()
+{
+    if (_treeDepth > 0)
+    {
+        _tree.onEnd();
+        if (--_treeDepth == 0)
+        {
+            *_treeTarget = _tree.result();
+        }
+        return SinSaxAction::Continue;
+    }
+    _stack.pop_back();
+    return SinSaxAction::Continue;
+}
@@ -0,0 +1,481 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sin.h"
+#include "sin_parser.h"
+#include "sin_sax.h"
+#include "sin_writer.h"
+
+/**
+ * Reads SIN straight into C++ structs and writes them straight to text,
+ * without a Sin tree in between:
+ *
+ *     struct Limits { int32_t rate; std::vector<int32_t> bursts; };
+ *     struct Config { uint16_t port; std::string host; Limits limits; };
+ *     SIN_BIND(Limits, rate, bursts)
+ *     SIN_BIND(Config, port, host, limits)
+ *
+ *     Config config = decodeSin<Config>(text);
+ *     std::string text = encodeSin(config);
+ *
+ * Members can be numbers, bool, std::string, std::vector of any of these,
+ * other bound structs and Sin, which takes whatever value is there as a
+ * tree. Members missing from the document keep their value, keys the
+ * struct doesn't have are skipped by the parser.
+ *
+ * A number is read into a member whose type holds its value: widening
+ * like Sin::get<T>, other integers when they are in range and a Double
+ * rounded to a float member, so `.port: 8080` fills a uint16_t. Other
+ * type mismatches throw std::invalid_argument like parse errors do.
+ */
+
+/**
+ * A bound struct member, as SIN_BIND lists them
+ */
+template <class T, class M>
+struct SinField
+{
+    std::string_view name;
+    M T::*member;
+};
+
+/**
+ * The members of T, specialized by SIN_BIND
+ */
+template <class T>
+struct SinFields;
+
+/**
+ * What the decoder does with the events for a value of some C++ type,
+ * there is one table per type. Functions of other kinds are null.
+ */
+struct SinBindOps
+{
+    enum class Kind
+    {
+        Scalar,
+        Object,
+        Array,
+        // a Sin, built by a SinTreeBuilder
+        Tree,
+    };
+
+    Kind kind;
+    // the type named in errors, Undefined for Tree
+    SinType type;
+    // false if the scalar doesn't fit
+    bool (*scalar)(void *target, const SinSaxScalar &scalar);
+    // containers: called on their begin event
+    void (*begin)(void *target);
+    // the target of an entry's value and its ops, nullptr to skip the entry
+    void *(*member)(void *target, std::string_view key, const SinBindOps *&ops);
+    void *(*element)(void *target, size_t index, const SinBindOps *&ops);
+};
+
+/**
+ * Reading and writing values of T, see SinBindOps. write writes the value
+ * like Sin::serialize(writer, pads), bare says whether compact output has
+ * to end it with SinWriter::endToken.
+ */
+template <class T, class Enable = void>
+struct SinCodec
+{
+    static_assert(sizeof(T) == 0, "members must be numbers, bool, std::string, std::vector, Sin or structs bound with SIN_BIND");
+};
+
+/**
+ * Whether an entry is left out when written, like the tree leaves out
+ * Sin::Undefined() values
+ */
+template <class T>
+bool skipSinEntry(const T &value)
+{
+    if constexpr (std::is_same_v<T, Sin>)
+    {
+        return value.typeId() == SinType::Undefined;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/**
+ * Writes value as the value of an entry at nesting level pads
+ */
+template <class T>
+void writeSinEntry(SinWriter &writer, int pads, const T &value)
+{
+    SinCodec<T>::write(writer, pads, value);
+    if (SinCodec<T>::bare(value))
+    {
+        writer.endToken();
+    }
+}
+
+template <class T>
+struct SinCodec<T, std::enable_if_t<sinNumberType<T>() != SinType::Undefined || std::is_same_v<T, bool>>>
+{
+    static bool read(void *target, const SinSaxScalar &scalar)
+    {
+        if (scalar.type == SinType::String)
+        {
+            return false;
+        }
+        Sin value = SinTreeBuilder::toSin(scalar, nullptr);
+        T &out = *static_cast<T *>(target);
+        if (auto exact = value.try_get<T>())
+        {
+            out = *exact;
+            return true;
+        }
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+        {
+            if (auto wide = value.try_get<int64_t>(); wide && std::in_range<T>(*wide))
+            {
+                out = static_cast<T>(*wide);
+                return true;
+            }
+            if (auto wide = value.try_get<uint64_t>(); wide && std::in_range<T>(*wide))
+            {
+                out = static_cast<T>(*wide);
+                return true;
+            }
+        }
+        else if constexpr (std::is_same_v<T, float>)
+        {
+            if (value.typeId() == SinType::Double)
+            {
+                out = static_cast<float>(value.asDouble());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static constexpr SinBindOps ops{
+        .kind = SinBindOps::Kind::Scalar,
+        .type = std::is_same_v<T, bool> ? SinType::Bool : sinNumberType<T>(),
+        .scalar = read,
+        .begin = nullptr,
+        .member = nullptr,
+        .element = nullptr,
+    };
+
+    static void write(SinWriter &writer, int pads, T value)
+    {
+        Sin(value).serialize(writer, pads);
+    }
+
+    static bool bare(T)
+    {
+        return true;
+    }
+};
+
+template <>
+struct SinCodec<std::string>
+{
+    static bool read(void *target, const SinSaxScalar &scalar)
+    {
+        if (scalar.type != SinType::String)
+        {
+            return false;
+        }
+        static_cast<std::string *>(target)->assign(scalar.text);
+        return true;
+    }
+
+    static constexpr SinBindOps ops{
+        .kind = SinBindOps::Kind::Scalar,
+        .type = SinType::String,
+        .scalar = read,
+        .begin = nullptr,
+        .member = nullptr,
+        .element = nullptr,
+    };
+
+    static void write(SinWriter &writer, int, const std::string &value)
+    {
+        writer.writeColon();
+        writer.put('"');
+        writer.writeEscaped(value);
+        writer.put('"');
+        writer.newline();
+    }
+
+    static bool bare(const std::string &)
+    {
+        return false;
+    }
+};
+
+template <>
+struct SinCodec<Sin>
+{
+    static constexpr SinBindOps ops{
+        .kind = SinBindOps::Kind::Tree,
+        .type = SinType::Undefined,
+        .scalar = nullptr,
+        .begin = nullptr,
+        .member = nullptr,
+        .element = nullptr,
+    };
+
+    static void write(SinWriter &writer, int pads, const Sin &value)
+    {
+        value.serialize(writer, pads);
+    }
+
+    static bool bare(const Sin &value)
+    {
+        return value.typeId() != SinType::String && value.typeId() != SinType::Array && value.typeId() != SinType::Object;
+    }
+};
+
+template <class T>
+struct SinCodec<std::vector<T>>
+{
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> has no addressable elements");
+
+    static void begin(void *target)
+    {
+        static_cast<std::vector<T> *>(target)->clear();
+    }
+
+    static void *element(void *target, size_t index, const SinBindOps *&ops)
+    {
+        auto &values = *static_cast<std::vector<T> *>(target);
+        if (index >= values.size())
+        {
+            values.resize(index + 1);
+        }
+        ops = &SinCodec<T>::ops;
+        return &values[index];
+    }
+
+    static constexpr SinBindOps ops{
+        .kind = SinBindOps::Kind::Array,
+        .type = SinType::Array,
+        .scalar = nullptr,
+        .begin = begin,
+        .member = nullptr,
+        .element = element,
+    };
+
+    static void write(SinWriter &writer, int pads, const std::vector<T> &values)
+    {
+        writer.writeColon();
+        writer.put('[');
+        writer.newline();
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (skipSinEntry(values[i]))
+            {
+                continue;
+            }
+            writer.writeIndex(pads + 1, i);
+            writeSinEntry(writer, pads + 1, values[i]);
+        }
+        writer.indent(pads);
+        writer.put(']');
+        writer.newline();
+    }
+
+    static bool bare(const std::vector<T> &)
+    {
+        return false;
+    }
+};
+
+template <class T>
+struct SinCodec<T, std::void_t<decltype(SinFields<T>::fields)>>
+{
+    static void *member(void *target, std::string_view key, const SinBindOps *&ops)
+    {
+        void *found = nullptr;
+        auto match = [&](const auto &field)
+        {
+            if (field.name != key)
+            {
+                return false;
+            }
+            auto &value = static_cast<T *>(target)->*field.member;
+            found = &value;
+            ops = &SinCodec<std::remove_cvref_t<decltype(value)>>::ops;
+            return true;
+        };
+        // stops at the first match
+        std::apply([&](const auto &...fields)
+                   { (match(fields) || ...); },
+                   SinFields<T>::fields);
+        return found;
+    }
+
+    static constexpr SinBindOps ops{
+        .kind = SinBindOps::Kind::Object,
+        .type = SinType::Object,
+        .scalar = nullptr,
+        .begin = nullptr,
+        .member = member,
+        .element = nullptr,
+    };
+
+    static void write(SinWriter &writer, int pads, const T &value)
+    {
+        writer.writeColon();
+        writer.put('{');
+        writer.newline();
+        auto writeMember = [&](const auto &field)
+        {
+            const auto &member = value.*field.member;
+            if (!skipSinEntry(member))
+            {
+                writer.writeKey(pads + 1, field.name);
+                writeSinEntry(writer, pads + 1, member);
+            }
+        };
+        std::apply([&](const auto &...fields)
+                   { (writeMember(fields), ...); },
+                   SinFields<T>::fields);
+        writer.indent(pads);
+        writer.put('}');
+        writer.newline();
+    }
+
+    static bool bare(const T &)
+    {
+        return false;
+    }
+};
+
+/**
+ * Handler that fills a bound value from the parser's events. It keeps its
+ * stacks from one document to the next, like a reused SinParser does.
+ */
+class SinBindDecoder : public SinSaxHandler
+{
+    struct Frame
+    {
+        void *target = nullptr;
+        const SinBindOps *ops = nullptr;
+    };
+
+    // the open objects and arrays
+    std::vector<Frame> _stack;
+    // what the next value goes into
+    Frame _next;
+    // Sin members are built as trees, _treeDepth counts their open containers
+    SinTreeBuilder _tree;
+    size_t _treeDepth = 0;
+    Sin *_treeTarget = nullptr;
+    std::string _error;
+
+    SinSaxAction begin(SinBindOps::Kind kind);
+    SinSaxAction mismatch(SinType actual);
+
+public:
+    template <class T>
+    void bind(T &value)
+    {
+        bind(&value, &SinCodec<T>::ops);
+    }
+
+    void bind(void *target, const SinBindOps *ops);
+
+    /**
+     * Why the decoder stopped the parse, empty if it didn't
+     */
+    const std::string &error() const;
+
+    SinSaxAction onObjectBegin() override;
+    SinSaxAction onArrayBegin() override;
+    SinSaxAction onKey(std::string_view key) override;
+    SinSaxAction onArrayIndex(size_t index) override;
+    SinSaxAction onScalar(const SinSaxScalar &scalar) override;
+    SinSaxAction onEnd() override;
+};
+
+/**
+ * Fills value from the document, throws std::invalid_argument for parse
+ * errors and for values that don't fit their members
+ */
+template <class T>
+void decodeSin(std::string_view str, T &value)
+{
+    SinBindDecoder decoder;
+    decoder.bind(value);
+    parseSin(str, decoder);
+    if (!decoder.error().empty())
+    {
+        throw std::invalid_argument(decoder.error());
+    }
+}
+
+template <class T>
+T decodeSin(std::string_view str)
+{
+    T value{};
+    decodeSin(str, value);
+    return value;
+}
+
+/**
+ * Writes the text a Sin tree with the same values would, except that
+ * members are in the order SIN_BIND lists them
+ */
+template <class T>
+void encodeSin(const T &value, SinWriter &writer)
+{
+    SinCodec<T>::write(writer, 0, value);
+}
+
+template <class T>
+std::string encodeSin(const T &value, const SinFormat &format = {})
+{
+    std::string result;
+    SinWriter writer(result, format);
+    encodeSin(value, writer);
+    return result;
+}
+
+#define SIN_BIND_EXPAND(X) X
+#define SIN_BIND_FIELD(TYPE, NAME) SinField<TYPE, decltype(TYPE::NAME)>{#NAME, &TYPE::NAME}
+#define SIN_BIND_1(TYPE, NAME) SIN_BIND_FIELD(TYPE, NAME)
+#define SIN_BIND_2(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_1(TYPE, __VA_ARGS__))
+#define SIN_BIND_3(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_2(TYPE, __VA_ARGS__))
+#define SIN_BIND_4(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_3(TYPE, __VA_ARGS__))
+#define SIN_BIND_5(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_4(TYPE, __VA_ARGS__))
+#define SIN_BIND_6(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_5(TYPE, __VA_ARGS__))
+#define SIN_BIND_7(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_6(TYPE, __VA_ARGS__))
+#define SIN_BIND_8(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_7(TYPE, __VA_ARGS__))
+#define SIN_BIND_9(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_8(TYPE, __VA_ARGS__))
+#define SIN_BIND_10(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_9(TYPE, __VA_ARGS__))
+#define SIN_BIND_11(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_10(TYPE, __VA_ARGS__))
+#define SIN_BIND_12(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_11(TYPE, __VA_ARGS__))
+#define SIN_BIND_13(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_12(TYPE, __VA_ARGS__))
+#define SIN_BIND_14(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_13(TYPE, __VA_ARGS__))
+#define SIN_BIND_15(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_14(TYPE, __VA_ARGS__))
+#define SIN_BIND_16(TYPE, NAME, ...) SIN_BIND_FIELD(TYPE, NAME), SIN_BIND_EXPAND(SIN_BIND_15(TYPE, __VA_ARGS__))
+#define SIN_BIND_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, NAME, ...) NAME
+
+/**
+ * Binds up to 16 members of TYPE, at global scope after its definition
+ */
+#define SIN_BIND(TYPE, ...)                                                                         \
+    template <>                                                                                     \
+    struct SinFields<TYPE>                                                                          \
+    {                                                                                               \
+        static constexpr auto fields = std::make_tuple(SIN_BIND_EXPAND(SIN_BIND_PICK(               \
+            __VA_ARGS__, SIN_BIND_16, SIN_BIND_15, SIN_BIND_14, SIN_BIND_13, SIN_BIND_12, SIN_BIND_11, \
+            SIN_BIND_10, SIN_BIND_9, SIN_BIND_8, SIN_BIND_7, SIN_BIND_6, SIN_BIND_5, SIN_BIND_4,      \
+            SIN_BIND_3, SIN_BIND_2, SIN_BIND_1)(TYPE, __VA_ARGS__)));                                \
+    };
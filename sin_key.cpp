@@ -0,0 +1,195 @@
+#include "sin_key.h"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <unordered_set>
+
+namespace
+{
+    struct Probe
+    {
+        std::string_view text;
+        uint32_t hash;
+    };
+
+    struct DataHash
+    {
+        using is_transparent = void;
+        size_t operator()(const SinKeyData *data) const { return data->hash; }
+        size_t operator()(const Probe &probe) const { return probe.hash; }
+    };
+
+    struct DataEqual
+    {
+        using is_transparent = void;
+        bool operator()(const SinKeyData *a, const SinKeyData *b) const { return a == b; }
+        bool operator()(const Probe &probe, const SinKeyData *data) const
+        {
+            return probe.hash == data->hash && probe.text == std::string_view(data->text, data->size);
+        }
+        bool operator()(const SinKeyData *data, const Probe &probe) const { return (*this)(probe, data); }
+    };
+
+    /**
+     * Sharded by hash so that threads parsing different documents rarely
+     * wait for each other
+     */
+    struct Pool
+    {
+        static constexpr size_t SHARDS = 64;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_set<SinKeyData *, DataHash, DataEqual> keys;
+        };
+
+        Shard shards[SHARDS];
+
+        Shard &shard(uint32_t hash)
+        {
+            return shards[hash >> 26];
+        }
+    };
+
+    // never destroyed, keys in static objects may outlive any other static
+    Pool &pool()
+    {
+        static Pool *pool = new Pool;
+        return *pool;
+    }
+}
+
+uint32_t SinKey::hashOf(std::string_view text)
+{
+    return static_cast<uint32_t>(std::hash<std::string_view>{}(text));
+}
+
+SinKey::SinKey(std::string_view text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+
+    const uint32_t hash = hashOf(text);
+    auto &shard = pool().shard(hash);
+    std::lock_guard lock(shard.mutex);
+
+    auto it = shard.keys.find(Probe{text, hash});
+    if (it != shard.keys.end())
+    {
+        (*it)->refs.fetch_add(1, std::memory_order_relaxed);
+        _data = *it;
+        return;
+    }
+
+    void *memory = ::operator new(offsetof(SinKeyData, text) + text.size());
+    _data = static_cast<SinKeyData *>(memory);
+    new (&_data->refs) std::atomic<uint32_t>(1);
+    _data->hash = hash;
+    _data->size = static_cast<uint32_t>(text.size());
+    std::memcpy(_data->text, text.data(), text.size());
+    shard.keys.insert(_data);
+}
+
+SinKey::SinKey(const SinKey &other) noexcept : _data{other._data}
+{
+    if (_data)
+    {
+        _data->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SinKey &SinKey::operator=(const SinKey &other) noexcept
+{
+    if (_data != other._data)
+    {
+        SinKey copy(other);
+        std::swap(_data, copy._data);
+    }
+    return *this;
+}
+
+SinKey &SinKey::operator=(SinKey &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        _data = other._data;
+        other._data = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * Only the last reference takes the lock. Interning a text adds a
+ * reference under the same lock, so a text can't come back while it is
+ * being removed.
+ */
+void SinKey::release() noexcept
+{
+    if (!_data)
+    {
+        return;
+    }
+
+    uint32_t refs = _data->refs.load(std::memory_order_relaxed);
+    while (refs > 1)
+    {
+        if (_data->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel))
+        {
+            _data = nullptr;
+            return;
+        }
+    }
+
+    auto &shard = pool().shard(_data->hash);
+    {
+        std::lock_guard lock(shard.mutex);
+        if (_data->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            _data = nullptr;
+            return;
+        }
+        shard.keys.erase(_data);
+    }
+    _data->refs.~atomic();
+    ::operator delete(_data);
+    _data = nullptr;
+}
+
+size_t SinKey::poolSize()
+{
+    size_t size = 0;
+    for (auto &shard : pool().shards)
+    {
+        std::lock_guard lock(shard.mutex);
+        size += shard.keys.size();
+    }
+    return size;
+}
+
+SinKey SinKeyCache::get(std::string_view text)
+{
+    auto it = _keys.find(text);
+    if (it == _keys.end())
+    {
+        SinKey key(text);
+        it = _keys.emplace(key.view(), key).first;
+    }
+    return it->second;
+}
+
+size_t SinKeyCache::size() const
+{
+    return _keys.size();
+}
+
+void SinKeyCache::clear()
+{
+    _keys.clear();
+}
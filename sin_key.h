@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * An interned key text, allocated with room for its characters. In the
+ * header so that reading a key's text and hash is inlined into lookups.
+ */
+struct SinKeyData
+{
+    std::atomic<uint32_t> refs;
+    uint32_t hash;
+    uint32_t size;
+    char text[1];
+};
+
+/**
+ * An object key, interned in a process wide pool.
+ *
+ * Every distinct key text is stored once, however many objects and
+ * documents use it, and a SinKey is one pointer to it. Two keys are equal
+ * exactly when they point to the same text, so comparing keys is a
+ * pointer compare. The hash of the text is computed once when it is
+ * interned.
+ *
+ * The pool is thread-safe and reference counted: copying a key is an
+ * atomic increment and a text leaves the pool with its last key. Interning
+ * takes a lock, parsers go through a SinKeyCache to do it once per
+ * distinct key.
+ */
+class SinKey
+{
+    SinKeyData *_data = nullptr;
+
+    void release() noexcept;
+
+public:
+    /**
+     * The empty key, it is not stored in the pool
+     */
+    SinKey() = default;
+    explicit SinKey(std::string_view text);
+
+    SinKey(const SinKey &other) noexcept;
+    SinKey(SinKey &&other) noexcept : _data{other._data}
+    {
+        other._data = nullptr;
+    }
+    SinKey &operator=(const SinKey &other) noexcept;
+    SinKey &operator=(SinKey &&other) noexcept;
+    ~SinKey()
+    {
+        release();
+    }
+
+    std::string_view view() const
+    {
+        return _data ? std::string_view(_data->text, _data->size) : std::string_view();
+    }
+
+    operator std::string_view() const
+    {
+        return view();
+    }
+
+    uint32_t hash() const
+    {
+        return _data ? _data->hash : hashOf({});
+    }
+
+    bool operator==(const SinKey &other) const
+    {
+        return _data == other._data;
+    }
+
+    /**
+     * The hash SinKey stores, for looking up keys by their text
+     */
+    static uint32_t hashOf(std::string_view text);
+
+    /**
+     * Number of distinct keys in the pool
+     */
+    static size_t poolSize();
+};
+
+/**
+ * Keys a parser has already interned, so that repeated keys skip the
+ * pool's lock. Holds a reference to every key it has seen.
+ */
+class SinKeyCache
+{
+    // the views point into the interned texts, which the keys keep alive
+    std::unordered_map<std::string_view, SinKey> _keys;
+
+public:
+    SinKey get(std::string_view text);
+    size_t size() const;
+    void clear();
+};
@@ -0,0 +1,254 @@
+#include "sin_lazy.h"
+#include "sin_parser_impl.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+SinLazyDocument::SinLazyDocument(std::string text, std::pmr::memory_resource *resource) : _text(std::move(text)), _resource(resource)
+{
+    if (_text.size() >= UINT32_MAX)
+    {
+        throw std::length_error("SinLazyDocument is limited to 4 GiB of text");
+    }
+
+    SinParser parser(_text, _resource, 0);
+    indexValue(parser);
+    _openMembers = {};
+    _openElements = {};
+
+    if (parser.error != "")
+    {
+        throw std::invalid_argument("Can't parse configuration: " + parser.error);
+    }
+}
+
+/**
+ * Records the value at the cursor and everything in it, returns its node
+ */
+uint32_t SinLazyDocument::indexValue(SinParser &parser)
+{
+    uint32_t id = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back(Node{static_cast<uint32_t>(parser.pos)});
+
+    int ch = parser.read_value_start();
+    if (ch == EOF)
+    {
+        return id;
+    }
+    if ((ch != '{') && (ch != '['))
+    {
+        parser.skip_value_after_start(ch);
+        return id;
+    }
+    parser.get_char();
+
+    // entries of nested containers are stored while this one is open, so
+    // ours are collected on top of the open entries and moved in one block
+    if (ch == '{')
+    {
+        size_t open = _openMembers.size();
+        std::string name;
+        while (true)
+        {
+            parser.skip_whitespace();
+            size_t keyStart = parser.pos + 1;
+            if (parser.read_object_key(name) != SinParser::Entry::Value)
+            {
+                break;
+            }
+            // `.name` and `[name]` keys are spans of the text, quoted keys may have been decoded
+            Member member{static_cast<uint32_t>(keyStart), static_cast<uint32_t>(name.size()), 0, 0};
+            if (std::string_view(_text).substr(keyStart, name.size()) != name)
+            {
+                member.keyBegin = static_cast<uint32_t>(_decodedKeys.size());
+                member.decoded = 1;
+                _decodedKeys += name;
+            }
+            member.node = indexValue(parser);
+            _openMembers.push_back(member);
+        }
+
+        // a repeated key keeps its last value, like the tree does
+        auto members = _openMembers.begin() + open;
+        std::stable_sort(members, _openMembers.end(), [this](const Member &a, const Member &b)
+                         { return key(a) < key(b); });
+        auto end = members;
+        for (auto it = members; it != _openMembers.end(); ++it)
+        {
+            if (end != members && key(*(end - 1)) == key(*it))
+            {
+                *(end - 1) = *it;
+            }
+            else
+            {
+                *end++ = *it;
+            }
+        }
+
+        _nodes[id].type = SinType::Object;
+        _nodes[id].first = static_cast<uint32_t>(_members.size());
+        _nodes[id].count = static_cast<uint32_t>(end - members);
+        _members.insert(_members.end(), members, end);
+        _openMembers.resize(open);
+    }
+    else
+    {
+        size_t open = _openElements.size();
+        int32_t index;
+        uint32_t count = 0;
+        while (parser.read_array_index(index) == SinParser::Entry::Value)
+        {
+            uint32_t child = indexValue(parser);
+            _openElements.emplace_back(uint32_t(index), child);
+            count = std::max(count, uint32_t(index) + 1);
+        }
+
+        // indexes that were not given are holes, later entries win
+        _nodes[id].type = SinType::Array;
+        _nodes[id].first = static_cast<uint32_t>(_elements.size());
+        _nodes[id].count = count;
+        _elements.resize(_elements.size() + count, NO_NODE);
+        for (size_t i = open; i < _openElements.size(); i++)
+        {
+            _elements[_nodes[id].first + _openElements[i].first] = _openElements[i].second;
+        }
+        _openElements.resize(open);
+    }
+
+    return id;
+}
+
+std::string_view SinLazyDocument::key(const Member &member) const
+{
+    return std::string_view(member.decoded ? _decodedKeys : _text).substr(member.keyBegin, member.keySize);
+}
+
+const Sin &SinLazyDocument::materialize(uint32_t node) const
+{
+    if (node == NO_NODE)
+    {
+        return _empty;
+    }
+
+    auto it = _values.find(node);
+    if (it != _values.end())
+    {
+        return it->second;
+    }
+
+    std::string_view text = std::string_view(_text).substr(_nodes[node].begin);
+    SinParser parser(text, _resource, 0);
+    Sin value = parser.read_sin_value();
+    if (parser.error != "")
+    {
+        // lines are only counted when they are needed for the message
+        size_t line = std::count(_text.begin(), _text.begin() + _nodes[node].begin, '\n');
+        SinParser numbered(text, _resource, line);
+        numbered.read_sin_value();
+        throw std::invalid_argument("Can't parse configuration: " + numbered.error);
+    }
+
+    return _values.emplace(node, std::move(value)).first->second;
+}
+
+SinLazyValue SinLazyDocument::root() const
+{
+    return SinLazyValue(this, 0);
+}
+
+size_t SinLazyDocument::nodeCount() const
+{
+    return _nodes.size();
+}
+
+SinType SinLazyValue::typeId() const
+{
+    if (_node == SinLazyDocument::NO_NODE)
+    {
+        return SinType::Undefined;
+    }
+    SinType type = _document->_nodes[_node].type;
+    return type == SinType::Undefined ? value().typeId() : type;
+}
+
+std::string SinLazyValue::type() const
+{
+    return sinTypeName(typeId());
+}
+
+size_t SinLazyValue::size() const
+{
+    const auto *node = _node == SinLazyDocument::NO_NODE ? nullptr : &_document->_nodes[_node];
+    if (!node || (node->type != SinType::Array && node->type != SinType::Object))
+    {
+        throw std::string("Type assertion. Requested type: Array or Object, Actual type: ") + type();
+    }
+    return node->count;
+}
+
+SinLazyValue SinLazyValue::operator[](size_t index) const
+{
+    if (typeId() != SinType::Array)
+    {
+        throw std::string("Type assertion. Requested type: Array, Actual type: ") + type();
+    }
+    const auto &node = _document->_nodes[_node];
+    if (index >= node.count)
+    {
+        throw std::out_of_range("Array index " + std::to_string(index) + " out of range");
+    }
+    return SinLazyValue(_document, _document->_elements[node.first + index]);
+}
+
+std::optional<SinLazyValue> SinLazyValue::find(std::string_view key) const
+{
+    if (_node == SinLazyDocument::NO_NODE || _document->_nodes[_node].type != SinType::Object)
+    {
+        throw std::string("Type assertion. Requested type: Object, Actual type: ") + type();
+    }
+
+    const auto &node = _document->_nodes[_node];
+    auto begin = _document->_members.begin() + node.first;
+    auto end = begin + node.count;
+    auto it = std::lower_bound(begin, end, key, [this](const SinLazyDocument::Member &member, std::string_view key)
+                               { return _document->key(member) < key; });
+    if (it == end || _document->key(*it) != key)
+    {
+        return std::nullopt;
+    }
+    return SinLazyValue(_document, it->node);
+}
+
+SinLazyValue SinLazyValue::operator[](std::string_view key) const
+{
+    auto value = find(key);
+    if (!value)
+    {
+        throw std::out_of_range("No member '" + std::string(key) + "'");
+    }
+    return *value;
+}
+
+const Sin &SinLazyValue::value() const
+{
+    return _document->materialize(_node);
+}
+
+#define SIN_LAZY_GETTER(SIN_TYPE, STANDARD_TYPE)   \
+    STANDARD_TYPE SinLazyValue::as##SIN_TYPE() const \
+    {                                              \
+        return value().as##SIN_TYPE();             \
+    }
+
+SIN_LAZY_GETTER(Uint8, uint8_t)
+SIN_LAZY_GETTER(Int8, int8_t)
+SIN_LAZY_GETTER(Uint16, uint16_t)
+SIN_LAZY_GETTER(Int16, int16_t)
+SIN_LAZY_GETTER(Uint32, uint32_t)
+SIN_LAZY_GETTER(Int32, int32_t)
+SIN_LAZY_GETTER(Uint64, uint64_t)
+SIN_LAZY_GETTER(Int64, int64_t)
+SIN_LAZY_GETTER(Float, float)
+SIN_LAZY_GETTER(Double, double)
+SIN_LAZY_GETTER(String, std::string)
+SIN_LAZY_GETTER(Bool, bool)
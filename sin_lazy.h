@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sin.h"
+
+class SinLazyValue;
+class SinParser;
+
+/**
+ * Document that is only parsed where it is read.
+ *
+ * The constructor makes one pass over the text that records where every
+ * value starts and, for objects and arrays, where their entries are,
+ * without converting or allocating any values. Scalars are skipped like
+ * the SAX parser skips them, so type and number errors only show up when
+ * the value is read.
+ *
+ * Reading a value parses its text with the regular parser the first time
+ * and caches the result. Values are read-only and a document must not be
+ * read from several threads at once.
+ */
+class SinLazyDocument
+{
+    friend class SinLazyValue;
+
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct Node
+    {
+        // offset of the value, including the whitespace before its ':'
+        uint32_t begin;
+        // entries in _members or _elements
+        uint32_t first = 0;
+        uint32_t count = 0;
+        // Object, Array, or Undefined for a scalar that wasn't read yet
+        SinType type = SinType::Undefined;
+    };
+
+    struct Member
+    {
+        // span of _text, or of _decodedKeys for `["quoted"]` keys
+        uint32_t keyBegin;
+        uint32_t keySize : 31;
+        uint32_t decoded : 1;
+        uint32_t node;
+    };
+
+    std::string _text;
+    std::pmr::memory_resource *_resource;
+
+    std::vector<Node> _nodes;
+    // members of each object sorted by key, elements of each array by index
+    std::vector<Member> _members;
+    std::vector<uint32_t> _elements;
+    std::string _decodedKeys;
+
+    // entries of the open containers, only used while indexing
+    std::vector<Member> _openMembers;
+    std::vector<std::pair<uint32_t, uint32_t>> _openElements;
+
+    mutable std::unordered_map<uint32_t, Sin> _values;
+    // holes of sparse arrays, like Sin::parse gives them
+    const Sin _empty = Sin::Undefined();
+
+    std::string_view key(const Member &member) const;
+    uint32_t indexValue(SinParser &parser);
+    const Sin &materialize(uint32_t node) const;
+
+public:
+    /**
+     * Indexes the text, throws std::invalid_argument if its structure is broken
+     */
+    explicit SinLazyDocument(std::string text, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    SinLazyDocument(const SinLazyDocument &) = delete;
+    SinLazyDocument &operator=(const SinLazyDocument &) = delete;
+
+    SinLazyValue root() const;
+
+    /**
+     * Number of indexed values, containers and scalars
+     */
+    size_t nodeCount() const;
+};
+
+/**
+ * A value inside a SinLazyDocument, valid as long as the document is
+ */
+class SinLazyValue
+{
+    friend class SinLazyDocument;
+
+    const SinLazyDocument *_document;
+    uint32_t _node;
+
+    SinLazyValue(const SinLazyDocument *document, uint32_t node) : _document{document}, _node{node} {}
+
+public:
+    SinType typeId() const;
+    std::string type() const;
+
+    /**
+     * Number of members of an Object or elements of an Array
+     */
+    size_t size() const;
+
+    /**
+     * Throws std::out_of_range for indexes past the end of the array
+     */
+    SinLazyValue operator[](size_t index) const;
+
+    /**
+     * Throws std::out_of_range if the object has no such member
+     */
+    SinLazyValue operator[](std::string_view key) const;
+
+    std::optional<SinLazyValue> find(std::string_view key) const;
+
+    /**
+     * The value as a regular tree, parsed on first use. Throws
+     * std::invalid_argument if its text doesn't parse.
+     */
+    const Sin &value() const;
+
+    uint8_t asUint8() const;
+    int8_t asInt8() const;
+    uint16_t asUint16() const;
+    int16_t asInt16() const;
+    uint32_t asUint32() const;
+    int32_t asInt32() const;
+    uint64_t asUint64() const;
+    int64_t asInt64() const;
+    float asFloat() const;
+    double asDouble() const;
+    std::string asString() const;
+    bool asBool() const;
+};
@@ -0,0 +1,765 @@
+#include "sin_object.h"
+#include "sin.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+SinObject::SinObject(const allocator_type &allocator)
+    : _entries(allocator.resource()), _order(allocator.resource()), _recent(allocator.resource()), _slots(allocator.resource())
+{
+}
+
+/**
+ * Like the vectors it had before, a copy takes its memory from the default resource
+ */
+SinObject::SinObject(const SinObject &other) : SinObject()
+{
+    copyEntries(other);
+}
+
+SinObject::SinObject(SinObject &&other) noexcept
+    : _entries(std::move(other._entries)), _order(std::move(other._order)), _recent(std::move(other._recent)),
+      _slots(std::move(other._slots)), _dead(std::exchange(other._dead, 0))
+{
+}
+
+SinObject &SinObject::operator=(const SinObject &other)
+{
+    if (this != &other)
+    {
+        clear();
+        copyEntries(other);
+    }
+    return *this;
+}
+
+SinObject &SinObject::operator=(SinObject &&other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    if (get_allocator() != other.get_allocator())
+    {
+        // the members belong to the other resource, they are copied into ours
+        *this = other;
+        other.clear();
+        return *this;
+    }
+    clear();
+    _entries = std::move(other._entries);
+    _order = std::move(other._order);
+    _recent = std::move(other._recent);
+    _slots = std::move(other._slots);
+    _dead = std::exchange(other._dead, 0);
+    return *this;
+}
+
+SinObject::~SinObject()
+{
+    clear();
+}
+
+/**
+ * Copies the members of other, dead ones included so that the positions
+ * stay valid, into this object's resource. This object is empty.
+ */
+void SinObject::copyEntries(const SinObject &other)
+{
+    _entries.reserve(other._entries.size());
+    for (const value_type *entry : other._entries)
+    {
+        SinKey key = entry->first;
+        Sin value = entry->second;
+        reserveOne();
+        _entries.push_back(newEntry(std::move(key), std::move(value)));
+    }
+    _order = other._order;
+    _recent = other._recent;
+    _slots = other._slots;
+    _dead = other._dead;
+}
+
+SinObject::value_type *SinObject::newEntry(SinKey &&key, Sin &&value)
+{
+    return get_allocator().new_object<value_type>(std::move(key), std::move(value));
+}
+
+void SinObject::deleteEntry(value_type *entry)
+{
+    get_allocator().delete_object(entry);
+}
+
+/**
+ * Makes sure a pointer can be added without throwing, so that a new entry
+ * is never lost between its allocation and the vector
+ */
+void SinObject::reserveOne()
+{
+    if (_entries.size() == _entries.capacity())
+    {
+        _entries.reserve(std::max<size_t>(4, _entries.size() * 2));
+    }
+}
+
+size_t SinObject::size() const
+{
+    return _entries.size() - _dead;
+}
+
+bool SinObject::empty() const
+{
+    return size() == 0;
+}
+
+SinObject::allocator_type SinObject::get_allocator() const
+{
+    return allocator_type(_entries.get_allocator().resource());
+}
+
+SinObject::Cursor SinObject::firstCursor() const
+{
+    if (_order.empty())
+    {
+        return {0, 0};
+    }
+    return {skipDead(0), skipDeadRecent(0)};
+}
+
+SinObject::Cursor SinObject::endCursor() const
+{
+    if (_order.empty())
+    {
+        return {_entries.size(), 0};
+    }
+    return {_order.size(), _recent.size()};
+}
+
+SinObject::Cursor SinObject::cursorOf(size_t position) const
+{
+    if (position == NPOS)
+    {
+        return endCursor();
+    }
+    if (_order.empty())
+    {
+        return {position, 0};
+    }
+    // a member of _order comes after the recent ones with its rank
+    std::string_view key = _entries[position]->first.view();
+    size_t rank = orderBound(key);
+    return {skipDead(rank), skipDeadRecent(recentBound(rank, key))};
+}
+
+/**
+ * Position of the member a cursor is at, NPOS at the end
+ */
+size_t SinObject::headAt(const Cursor &cursor) const
+{
+    if (_order.empty())
+    {
+        return cursor.order < _entries.size() ? cursor.order : NPOS;
+    }
+    if (cursor.recent < _recent.size() && _recent[cursor.recent].rank <= cursor.order)
+    {
+        return _recent[cursor.recent].position;
+    }
+    return cursor.order < _order.size() ? _order[cursor.order] : NPOS;
+}
+
+size_t SinObject::stepForward(Cursor &cursor) const
+{
+    if (_order.empty())
+    {
+        return headAt({++cursor.order, 0});
+    }
+    if (cursor.recent < _recent.size() && _recent[cursor.recent].rank <= cursor.order)
+    {
+        cursor.recent = skipDeadRecent(cursor.recent + 1);
+    }
+    else
+    {
+        cursor.order = skipDead(cursor.order + 1);
+    }
+    return headAt(cursor);
+}
+
+size_t SinObject::stepBack(Cursor &cursor) const
+{
+    if (_order.empty())
+    {
+        return headAt({--cursor.order, 0});
+    }
+    size_t ordered = cursor.order;
+    while (ordered > 0 && (_order[ordered - 1] & DEAD))
+    {
+        ordered--;
+    }
+    size_t recent = cursor.recent;
+    while (recent > 0 && (_recent[recent - 1].position & DEAD))
+    {
+        recent--;
+    }
+
+    // a recent member comes after the ordered one before its rank
+    if (recent > 0 && (ordered == 0 || _recent[recent - 1].rank >= ordered))
+    {
+        cursor.recent = recent - 1;
+        return _recent[cursor.recent].position;
+    }
+    cursor.order = ordered - 1;
+    return _order[cursor.order];
+}
+
+size_t SinObject::skipDead(size_t rank) const
+{
+    while (rank < _order.size() && (_order[rank] & DEAD))
+    {
+        rank++;
+    }
+    return rank;
+}
+
+size_t SinObject::skipDeadRecent(size_t index) const
+{
+    while (index < _recent.size() && (_recent[index].position & DEAD))
+    {
+        index++;
+    }
+    return index;
+}
+
+/**
+ * Rank of the first member whose key is not less than key, without an index
+ */
+size_t SinObject::lowerBound(std::string_view key) const
+{
+    size_t low = 0;
+    size_t high = _entries.size();
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if (_entries[middle]->first.view() < key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * The same over _order, dead members keep their keys
+ */
+size_t SinObject::orderBound(std::string_view key) const
+{
+    size_t low = 0;
+    size_t high = _order.size();
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if (_entries[_order[middle] & ~DEAD]->first.view() < key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Index of the first recent member that goes before a later rank or has a
+ * key that is not less than key, keys are only compared within a rank
+ */
+size_t SinObject::recentBound(size_t rank, std::string_view key) const
+{
+    size_t low = 0;
+    size_t high = _recent.size();
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        const Recent &recent = _recent[middle];
+        if (recent.rank < rank || (recent.rank == rank && _entries[recent.position & ~DEAD]->first.view() < key))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Slot of key in the table, dead or alive, or NPOS if it is missing
+ */
+size_t SinObject::slotOf(std::string_view key) const
+{
+    const uint32_t keyHash = SinKey::hashOf(key);
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = keyHash & mask;; i = (i + 1) & mask)
+    {
+        uint32_t slot = _slots[i];
+        if (slot == 0)
+        {
+            return NPOS;
+        }
+        const SinKey &candidate = _entries[(slot & ~DEAD) - 1]->first;
+        if (candidate.hash() == keyHash && candidate.view() == key)
+        {
+            return i;
+        }
+    }
+}
+
+size_t SinObject::slotOf(const SinKey &key) const
+{
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = key.hash() & mask;; i = (i + 1) & mask)
+    {
+        uint32_t slot = _slots[i];
+        if (slot == 0)
+        {
+            return NPOS;
+        }
+        if (_entries[(slot & ~DEAD) - 1]->first == key)
+        {
+            return i;
+        }
+    }
+}
+
+/**
+ * Position of key in _entries, or NPOS if it is missing
+ */
+size_t SinObject::indexOf(std::string_view key) const
+{
+    if (_slots.empty())
+    {
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            if (_entries[i]->first.view() == key)
+            {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+    size_t slot = slotOf(key);
+    return slot == NPOS || (_slots[slot] & DEAD) ? NPOS : _slots[slot] - 1;
+}
+
+size_t SinObject::indexOf(const SinKey &key) const
+{
+    if (_slots.empty())
+    {
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            if (_entries[i]->first == key)
+            {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+    size_t slot = slotOf(key);
+    return slot == NPOS || (_slots[slot] & DEAD) ? NPOS : _slots[slot] - 1;
+}
+
+SinObject::iterator SinObject::find(std::string_view key)
+{
+    size_t position = indexOf(key);
+    return iterator(this, position, position == NPOS ? endCursor() : _order.empty() ? Cursor{position, 0} : Cursor{});
+}
+
+SinObject::const_iterator SinObject::find(std::string_view key) const
+{
+    size_t position = indexOf(key);
+    return const_iterator(this, position, position == NPOS ? endCursor() : _order.empty() ? Cursor{position, 0} : Cursor{});
+}
+
+SinObject::iterator SinObject::find(const SinKey &key)
+{
+    size_t position = indexOf(key);
+    return iterator(this, position, position == NPOS ? endCursor() : _order.empty() ? Cursor{position, 0} : Cursor{});
+}
+
+SinObject::const_iterator SinObject::find(const SinKey &key) const
+{
+    size_t position = indexOf(key);
+    return const_iterator(this, position, position == NPOS ? endCursor() : _order.empty() ? Cursor{position, 0} : Cursor{});
+}
+
+bool SinObject::contains(std::string_view key) const
+{
+    return indexOf(key) != NPOS;
+}
+
+Sin &SinObject::operator[](std::string_view key)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        return _entries[position]->second;
+    }
+    return emplaceNew(SinKey(key), Sin{}).first->second;
+}
+
+Sin &SinObject::operator[](const SinKey &key)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        return _entries[position]->second;
+    }
+    return emplaceNew(SinKey(key), Sin{}).first->second;
+}
+
+std::pair<SinObject::iterator, bool> SinObject::try_emplace(std::string_view key, Sin value)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        return {iterator(this, position, Cursor{}), false};
+    }
+    return emplaceNew(SinKey(key), std::move(value));
+}
+
+std::pair<SinObject::iterator, bool> SinObject::try_emplace(SinKey key, Sin value)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        return {iterator(this, position, Cursor{}), false};
+    }
+    return emplaceNew(std::move(key), std::move(value));
+}
+
+/**
+ * Adds a key that is not in the object yet
+ */
+std::pair<SinObject::iterator, bool> SinObject::emplaceNew(SinKey &&key, Sin &&value)
+{
+    size_t position = insertAt(std::move(key), std::move(value));
+    return {iterator(this, position, Cursor{}), true};
+}
+
+std::pair<SinObject::iterator, bool> SinObject::insert_or_assign(std::string_view key, Sin value)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        _entries[position]->second = std::move(value);
+        return {iterator(this, position, Cursor{}), false};
+    }
+    return emplaceNew(SinKey(key), std::move(value));
+}
+
+std::pair<SinObject::iterator, bool> SinObject::insert_or_assign(SinKey key, Sin value)
+{
+    size_t position = indexOf(key);
+    if (position != NPOS)
+    {
+        _entries[position]->second = std::move(value);
+        return {iterator(this, position, Cursor{}), false};
+    }
+    return emplaceNew(std::move(key), std::move(value));
+}
+
+/**
+ * Adds the member, returns its position
+ */
+size_t SinObject::insertAt(SinKey &&key, Sin &&value)
+{
+    if (_order.empty())
+    {
+        // keys that arrive in order, as they do from the parser, go to the end
+        size_t rank = _entries.size();
+        if (rank > 0 && key.view() < _entries[rank - 1]->first.view())
+        {
+            rank = lowerBound(key);
+        }
+        reserveOne();
+        _entries.insert(_entries.begin() + rank, newEntry(std::move(key), std::move(value)));
+        if (_entries.size() >= INDEX_MIN)
+        {
+            buildIndex();
+        }
+        return rank;
+    }
+
+    if (_dead > 0)
+    {
+        // an erased key comes back to its old place
+        size_t slot = slotOf(key);
+        if (slot != NPOS)
+        {
+            size_t position = (_slots[slot] & ~DEAD) - 1;
+            _slots[slot] &= ~DEAD;
+            setDead(position, false);
+            _entries[position]->second = std::move(value);
+            _dead--;
+            return position;
+        }
+        if ((_entries.size() + 1) * 2 > _slots.size())
+        {
+            // the table would grow, drop the dead members instead of copying them
+            sortEntries();
+            buildIndex();
+        }
+    }
+
+    size_t position = _entries.size();
+    reserveOne();
+    _entries.push_back(newEntry(std::move(key), std::move(value)));
+    addPosition(position);
+    if (_entries.size() * 2 > _slots.size())
+    {
+        rebuildSlots();
+    }
+    else
+    {
+        addSlot(position);
+    }
+    return position;
+}
+
+/**
+ * Puts a new member in key order. Most keys arrive in order and go to the
+ * end, the others are kept apart until there are too many of them to
+ * search and insert into quickly.
+ */
+void SinObject::addPosition(size_t position)
+{
+    std::string_view key = _entries[position]->first.view();
+    if (_entries[_order.back() & ~DEAD]->first.view() < key)
+    {
+        _order.push_back(static_cast<uint32_t>(position));
+        return;
+    }
+
+    size_t rank = orderBound(key);
+    _recent.insert(_recent.begin() + recentBound(rank, key), Recent{static_cast<uint32_t>(rank), static_cast<uint32_t>(position)});
+    if (_recent.size() <= INDEX_MIN || _recent.size() * _recent.size() <= _entries.size())
+    {
+        return;
+    }
+
+    // the ranks say where each recent member goes, no keys are compared
+    std::pmr::vector<uint32_t> merged(_order.get_allocator());
+    merged.reserve(_order.size() + _recent.size());
+    size_t next = 0;
+    for (const Recent &recent : _recent)
+    {
+        merged.insert(merged.end(), _order.begin() + next, _order.begin() + recent.rank);
+        merged.push_back(recent.position);
+        next = recent.rank;
+    }
+    merged.insert(merged.end(), _order.begin() + next, _order.end());
+    _order.swap(merged);
+    _recent.clear();
+}
+
+/**
+ * Marks or unmarks the member's place in key order, the caller does its slot
+ */
+void SinObject::setDead(size_t position, bool dead)
+{
+    std::string_view key = _entries[position]->first.view();
+    size_t rank = orderBound(key);
+    uint32_t &entry = rank < _order.size() && (_order[rank] & ~DEAD) == position ? _order[rank] : _recent[recentBound(rank, key)].position;
+    entry = dead ? entry | DEAD : entry & ~DEAD;
+}
+
+size_t SinObject::erase(std::string_view key)
+{
+    if (_slots.empty())
+    {
+        size_t position = indexOf(key);
+        if (position == NPOS)
+        {
+            return 0;
+        }
+        deleteEntry(_entries[position]);
+        _entries.erase(_entries.begin() + position);
+        return 1;
+    }
+
+    size_t slot = slotOf(key);
+    if (slot == NPOS || (_slots[slot] & DEAD))
+    {
+        return 0;
+    }
+    // the key stays in place so that the order and the probing still work
+    size_t position = _slots[slot] - 1;
+    _slots[slot] |= DEAD;
+    setDead(position, true);
+    _entries[position]->second = Sin::Undefined();
+    _dead++;
+
+    if (size() < INDEX_MIN)
+    {
+        dropIndex();
+    }
+    else if (_dead * 2 > _entries.size())
+    {
+        sortEntries();
+        buildIndex();
+    }
+    return 1;
+}
+
+void SinObject::clear()
+{
+    for (value_type *entry : _entries)
+    {
+        deleteEntry(entry);
+    }
+    _entries.clear();
+    _order.clear();
+    _recent.clear();
+    _slots.clear();
+    _dead = 0;
+}
+
+void SinObject::reserve(size_t size)
+{
+    _entries.reserve(size);
+}
+
+void SinObject::appendUnsorted(std::string_view key, Sin value)
+{
+    appendUnsorted(SinKey(key), std::move(value));
+}
+
+void SinObject::appendUnsorted(SinKey key, Sin value)
+{
+    if (!_order.empty())
+    {
+        dropIndex();
+    }
+    reserveOne();
+    _entries.push_back(newEntry(std::move(key), std::move(value)));
+}
+
+void SinObject::sortKeys()
+{
+    if (!_order.empty())
+    {
+        return;
+    }
+
+    auto less = [](const value_type *a, const value_type *b)
+    {
+        return a->first.view() < b->first.view();
+    };
+
+    // strictly ascending already: nothing to sort and no duplicates
+    if (std::adjacent_find(_entries.begin(), _entries.end(), [&](const value_type *a, const value_type *b)
+                           { return !less(a, b); }) != _entries.end())
+    {
+        std::stable_sort(_entries.begin(), _entries.end(), less);
+
+        auto end = _entries.begin();
+        for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (end != _entries.begin() && (*(end - 1))->first == (*it)->first)
+            {
+                (*(end - 1))->second = std::move((*it)->second);
+                deleteEntry(*it);
+            }
+            else
+            {
+                *end++ = *it;
+            }
+        }
+        _entries.erase(end, _entries.end());
+    }
+
+    if (_entries.size() >= INDEX_MIN)
+    {
+        buildIndex();
+    }
+}
+
+/**
+ * Moves the live members into key order, the index is stale afterwards
+ */
+void SinObject::sortEntries()
+{
+    std::pmr::vector<value_type *> sorted(_entries.get_allocator());
+    sorted.reserve(size());
+    Cursor cursor = firstCursor();
+    for (size_t position = headAt(cursor); position != NPOS; position = stepForward(cursor))
+    {
+        sorted.push_back(std::exchange(_entries[position], nullptr));
+    }
+    // what is left are the erased members
+    for (value_type *entry : _entries)
+    {
+        if (entry)
+        {
+            deleteEntry(entry);
+        }
+    }
+    _entries.swap(sorted);
+    _dead = 0;
+}
+
+/**
+ * Back to a flat vector sorted by key
+ */
+void SinObject::dropIndex()
+{
+    sortEntries();
+    _order.clear();
+    _recent.clear();
+    _slots.clear();
+}
+
+/**
+ * Index over members that are sorted by key
+ */
+void SinObject::buildIndex()
+{
+    _order.resize(_entries.size());
+    std::iota(_order.begin(), _order.end(), 0);
+    _recent.clear();
+    rebuildSlots();
+}
+
+/**
+ * Only for members without dead ones, which are dropped before the table grows
+ */
+void SinObject::rebuildSlots()
+{
+    size_t capacity = 32;
+    while (capacity < _entries.size() * 4)
+    {
+        capacity *= 2;
+    }
+    _slots.assign(capacity, 0);
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        addSlot(i);
+    }
+}
+
+void SinObject::addSlot(size_t position)
+{
+    const size_t mask = _slots.size() - 1;
+    size_t i = _entries[position]->first.hash() & mask;
+    while (_slots[i] != 0)
+    {
+        i = (i + 1) & mask;
+    }
+    _slots[i] = static_cast<uint32_t>(position + 1);
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sin_key.h"
+
+class Sin;
+
+/**
+ * Members of a SIN object, iterated in key order so that serialization is
+ * deterministic.
+ *
+ * Every member is allocated on its own from the object's resource, so
+ * references to members stay valid while others are added or erased, as
+ * they do with std::map. The vectors below only hold pointers to them.
+ *
+ * Small objects keep the pointers sorted by key and are searched with a
+ * linear scan. From INDEX_MIN members on, members stay where they were
+ * added, their positions are kept in key order in a separate vector and
+ * an open addressing table over the keys' hashes finds them, so lookups
+ * don't depend on the size of the object.
+ *
+ * Keys added in order go to the end of the positions. Keys added out of
+ * order go to a short vector of their own with the rank they go before,
+ * which is merged into the positions once it outgrows the square root of
+ * the size, and iteration walks both. Erasing a member only marks it dead,
+ * dead members are dropped all at once when they are half of the object
+ * or when the table grows, so adding and erasing members don't move the
+ * others.
+ *
+ * Keys are interned SinKeys. Looking up a SinKey compares pointers, looking
+ * up text compares the hash first, and adding a member by its text interns
+ * the text.
+ *
+ * Builders that see keys in any order can use appendUnsorted and sortKeys.
+ * Keys must not be changed through iterators.
+ */
+class SinObject
+{
+    static constexpr size_t NPOS = SIZE_MAX;
+    // marks the positions and slots of erased members
+    static constexpr uint32_t DEAD = 0x80000000;
+
+    /**
+     * A position added out of key order and the rank in the positions that
+     * it goes before, which appending to the positions doesn't change
+     */
+    struct Recent
+    {
+        uint32_t rank;
+        uint32_t position;
+    };
+
+    /**
+     * Where a walk in key order is: the next ranks in the positions and in
+     * the recently added positions, both past dead members
+     */
+    struct Cursor
+    {
+        size_t order = NPOS;
+        size_t recent = 0;
+    };
+
+public:
+    using value_type = std::pair<SinKey, Sin>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+
+    static constexpr size_t INDEX_MIN = 16;
+
+    /**
+     * Walks members in key order. An iterator from find only knows where its
+     * member is, its first step searches for the member's place in the order.
+     */
+    template <bool Const>
+    class Iterator
+    {
+        friend class SinObject;
+        using Object = std::conditional_t<Const, const SinObject, SinObject>;
+
+        Object *_object = nullptr;
+        size_t _position = NPOS;
+        Cursor _cursor;
+
+        Iterator(Object *object, size_t position, Cursor cursor) : _object{object}, _position{position}, _cursor{cursor} {}
+
+        void step(bool forward)
+        {
+            if (_cursor.order == NPOS)
+            {
+                _cursor = _object->cursorOf(_position);
+            }
+            _position = forward ? _object->stepForward(_cursor) : _object->stepBack(_cursor);
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = SinObject::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+        Iterator() = default;
+
+        operator Iterator<true>() const
+        {
+            return Iterator<true>(_object, _position, _cursor);
+        }
+
+        reference operator*() const
+        {
+            return *_object->_entries[_position];
+        }
+
+        pointer operator->() const
+        {
+            return _object->_entries[_position];
+        }
+
+        Iterator &operator++()
+        {
+            step(true);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            step(true);
+            return old;
+        }
+
+        Iterator &operator--()
+        {
+            step(false);
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator old = *this;
+            step(false);
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return _position == other._position;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit SinObject(const allocator_type &allocator = {});
+    SinObject(const SinObject &other);
+    SinObject(SinObject &&other) noexcept;
+    SinObject &operator=(const SinObject &other);
+    /**
+     * Takes the members over when both objects use the same resource.
+     * Otherwise they are copied into this object's resource, and running
+     * out of memory while doing so terminates.
+     */
+    SinObject &operator=(SinObject &&other) noexcept;
+    ~SinObject();
+
+    iterator begin() { return iterator(this, headAt(firstCursor()), firstCursor()); }
+    iterator end() { return iterator(this, NPOS, endCursor()); }
+    const_iterator begin() const { return const_iterator(this, headAt(firstCursor()), firstCursor()); }
+    const_iterator end() const { return const_iterator(this, NPOS, endCursor()); }
+    size_t size() const;
+    bool empty() const;
+    allocator_type get_allocator() const;
+
+    iterator find(std::string_view key);
+    const_iterator find(std::string_view key) const;
+    iterator find(const SinKey &key);
+    const_iterator find(const SinKey &key) const;
+    bool contains(std::string_view key) const;
+
+    /**
+     * The value of key, an empty value is added if there is none
+     */
+    Sin &operator[](std::string_view key);
+    Sin &operator[](const SinKey &key);
+
+    /**
+     * Adds key with value unless it is there already, like std::map::try_emplace
+     */
+    std::pair<iterator, bool> try_emplace(std::string_view key, Sin value);
+    std::pair<iterator, bool> try_emplace(SinKey key, Sin value);
+    std::pair<iterator, bool> insert_or_assign(std::string_view key, Sin value);
+    std::pair<iterator, bool> insert_or_assign(SinKey key, Sin value);
+
+    size_t erase(std::string_view key);
+    void clear();
+    void reserve(size_t size);
+
+    /**
+     * Adds a member at the end without looking for its place or for
+     * duplicates. Lookups and iteration are wrong until sortKeys is called.
+     */
+    void appendUnsorted(std::string_view key, Sin value);
+    void appendUnsorted(SinKey key, Sin value);
+
+    /**
+     * Restores key order after appendUnsorted, a repeated key keeps the
+     * value that was appended last
+     */
+    void sortKeys();
+
+private:
+    // sorted by key while there is no index, in the order they were added after that
+    std::pmr::vector<value_type *> _entries;
+    // with an index: positions of the members in key order, positions added
+    // out of order since the last merge, also in key order, and a table of
+    // position + 1 with 0 for a free slot, its size is a power of two
+    std::pmr::vector<uint32_t> _order;
+    std::pmr::vector<Recent> _recent;
+    std::pmr::vector<uint32_t> _slots;
+    // erased members that are still in _entries
+    size_t _dead = 0;
+
+    Cursor firstCursor() const;
+    Cursor endCursor() const;
+    Cursor cursorOf(size_t position) const;
+    size_t headAt(const Cursor &cursor) const;
+    size_t stepForward(Cursor &cursor) const;
+    size_t stepBack(Cursor &cursor) const;
+    size_t skipDead(size_t rank) const;
+    size_t skipDeadRecent(size_t index) const;
+    size_t lowerBound(std::string_view key) const;
+    size_t orderBound(std::string_view key) const;
+    size_t recentBound(size_t rank, std::string_view key) const;
+    size_t slotOf(std::string_view key) const;
+    size_t slotOf(const SinKey &key) const;
+    size_t indexOf(std::string_view key) const;
+    size_t indexOf(const SinKey &key) const;
+    value_type *newEntry(SinKey &&key, Sin &&value);
+    void deleteEntry(value_type *entry);
+    void reserveOne();
+    void copyEntries(const SinObject &other);
+    std::pair<iterator, bool> emplaceNew(SinKey &&key, Sin &&value);
+    size_t insertAt(SinKey &&key, Sin &&value);
+    void addPosition(size_t position);
+    void setDead(size_t position, bool dead);
+    void sortEntries();
+    void dropIndex();
+    void buildIndex();
+    void rebuildSlots();
+    void addSlot(size_t position);
+};
@@ -0,0 +1,162 @@
+#include "sin_parser.h"
+#include "sin_parser_impl.h"
+#include "sin_sax.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * An entry of the root container as the pre-scan found it
+     */
+    struct RootEntry
+    {
+        std::string key;
+        int32_t index = 0;
+        // the value, from the whitespace before its ':' up to the next entry
+        size_t begin = 0;
+        size_t end = 0;
+        size_t line = 0;
+        Sin value;
+    };
+}
+
+Sin parseSinParallel(std::string_view str, unsigned threads, std::pmr::memory_resource *resource)
+{
+    if (threads == 0)
+    {
+        // a single core gains nothing from the pre-scan
+        threads = std::thread::hardware_concurrency();
+        if (threads <= 1)
+        {
+            return parseSin(str, resource);
+        }
+    }
+
+    // the pre-scan skips values, which finds where they end without parsing them
+    SinParser scanner(str, resource, 0);
+    int ch = scanner.read_value_start();
+    if (ch != '{' && ch != '[')
+    {
+        return parseSin(str, resource);
+    }
+    scanner.get_char();
+
+    const bool object = ch == '{';
+    std::vector<RootEntry> entries;
+    while (true)
+    {
+        RootEntry entry;
+        auto next = object ? scanner.read_object_key(entry.key) : scanner.read_array_index(entry.index);
+        if (next == SinParser::Entry::End)
+        {
+            break;
+        }
+        entry.begin = scanner.pos;
+        entry.line = scanner.line_number;
+        scanner.skip_value();
+        scanner.skip_whitespace();
+        entry.end = scanner.pos;
+        entries.push_back(std::move(entry));
+    }
+
+    if (!scanner.error.empty() || entries.size() < 2)
+    {
+        return parseSin(str, resource);
+    }
+
+    // a few batches per thread of about the same size in bytes, taken in turn
+    const size_t batch_bytes = std::max<size_t>(1, (scanner.pos / threads) / 4);
+    std::vector<size_t> batches = {0};
+    for (size_t i = 1; i < entries.size(); i++)
+    {
+        if (entries[i].begin - entries[batches.back()].begin >= batch_bytes)
+        {
+            batches.push_back(i);
+        }
+    }
+    batches.push_back(entries.size());
+
+    std::atomic<size_t> next_batch{0};
+    std::atomic<bool> failed{false};
+    auto work = [&]
+    {
+        // one parser per thread: its builder interns each distinct key once,
+        // not once per entry through the shared pool
+        SinParser parser;
+        size_t batch;
+        while (!failed && (batch = next_batch++) + 1 < batches.size())
+        {
+            for (size_t i = batches[batch]; i < batches[batch + 1]; i++)
+            {
+                RootEntry &entry = entries[i];
+                try
+                {
+                    entry.value = parser.read_piece(str.substr(entry.begin, entry.end - entry.begin), resource, entry.line);
+                    parser.skip_whitespace();
+                    // the value must end where the pre-scan thought it does
+                    if (!parser.error.empty() || !parser.eof())
+                    {
+                        failed = true;
+                    }
+                }
+                catch (...)
+                {
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    threads = static_cast<unsigned>(std::min<size_t>(threads, batches.size() - 1));
+    for (unsigned i = 1; i < threads; i++)
+    {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    // errors are reported by a sequential parse, with its exact message
+    if (failed)
+    {
+        return parseSin(str, resource);
+    }
+
+    Sin root = object ? Sin::Object(resource) : Sin::Array(resource);
+    if (object)
+    {
+        root.asObject().reserve(entries.size());
+    }
+    else
+    {
+        root.asArray().reserve(entries.size());
+    }
+    for (auto &entry : entries)
+    {
+        if (object)
+        {
+            root.asObject().appendUnsorted(entry.key, std::move(entry.value));
+        }
+        else
+        {
+            SinTreeBuilder::addElement(root, size_t(entry.index), std::move(entry.value));
+        }
+    }
+    if (object)
+    {
+        // key order, the last of repeated keys wins like in the tree builder
+        root.asObject().sortKeys();
+    }
+    else
+    {
+        SinTreeBuilder::packArray(root);
+    }
+    return root;
+}
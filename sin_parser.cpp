@@ -1,22 +1,39 @@
+#include <charconv>
+#include <climits>
+#include <cstdint>
 #include <memory>
+#include <system_error>
 #include <vector>
 #include <map>
 
 #include "sin.h"
 #include "sin_parser.h"
 #include "sin_parser_impl.h"
+#include "sin_sax.h"
+#include "sin_scan.h"
 #include "sin_value.h"
 
-const std::set<char> whitespace = {' ', '\t', '\n', '\r'};
-const std::set<char> whitespace_or_colon = {' ', '\t', '\n', '\r', ':'};
+bool SinParser::eof() const
+{
+    return pos >= input.size();
+}
+
+int SinParser::peek_char() const
+{
+    if (eof())
+    {
+        return EOF;
+    }
+    return static_cast<unsigned char>(input[pos]);
+}
 
 int SinParser::get_char()
 {
-    if (ss.eof())
+    if (eof())
     {
         return EOF;
     }
-    int ch = ss.get();
+    int ch = static_cast<unsigned char>(input[pos++]);
     if (ch == '\n')
     {
         line_number++;
@@ -24,76 +41,124 @@ int SinParser::get_char()
     return ch;
 }
 
-void SinParser::skip_chars(const std::set<char> &chars)
+void SinParser::skip_whitespace()
 {
-    while (!ss.eof())
+    pos += scan.skipWhitespace(input.data() + pos, input.size() - pos, &line_number);
+}
+
+std::string_view SinParser::read_till_char(uint8_t classes)
+{
+    size_t start = pos;
+    while (pos < input.size() && !sinCharIs(input[pos], classes))
     {
-        char ch = ss.peek();
-        if (chars.contains(ch))
+        if (input[pos] == '\n')
         {
-            get_char();
-        }
-        else
-        {
-            break;
+            line_number++;
         }
+        pos++;
     }
+    return input.substr(start, pos - start);
 }
 
-void SinParser::skip_whitespace()
+std::string_view SinParser::read_till_char_with_escape(char terminating_char, const SinEscapeTable &escapes)
 {
-    skip_chars(whitespace);
-}
+    // the run up to the next terminator or backslash needs no decoding
+    size_t run_start = pos;
+    pos += scan.findStringStop(input.data() + pos, input.size() - pos, terminating_char, &line_number);
+    if (eof() || input[pos] == terminating_char)
+    {
+        return input.substr(run_start, pos - run_start);
+    }
 
-std::string SinParser::read_till_char(const std::set<char> &chars)
-{
-    std::string res;
+    std::string &res = string_buffer;
+    res.assign(input.substr(run_start, pos - run_start));
     while (true)
     {
-        int ch = ss.peek();
-        if (chars.contains(ch) || (ch == EOF))
+        get_char(); // backslash
+        int escaped = get_char();
+        if (escaped == EOF)
         {
-            break;
+            error += "\nUnexpected EOF after backslash at line " + std::to_string(line_number);
+            return res;
+        }
+        char decoded = escapes[escaped];
+        if (decoded)
+        {
+            res += decoded;
         }
         else
         {
-            res += ch;
-            get_char();
+            res += '\\';
+            res += static_cast<char>(escaped);
+        }
+
+        run_start = pos;
+        pos += scan.findStringStop(input.data() + pos, input.size() - pos, terminating_char, &line_number);
+        res.append(input.substr(run_start, pos - run_start));
+        if (eof() || input[pos] == terminating_char)
+        {
+            return res;
         }
     }
-    return res;
 }
 
-std::string SinParser::read_till_char_with_escape(const std::set<char> &terminating_chars, const std::map<char, std::string> &escapes)
+/**
+ * std::from_chars over the whole token. Like the std::sto* functions it
+ * accepts a leading '+', but it never throws and never allocates.
+ */
+template <class T>
+static std::errc parse_number(std::string_view text, T &value)
 {
-    std::string res;
-    while (true)
+    if (text.size() > 1 && text[0] == '+')
     {
-        int ch = ss.peek();
-        if (terminating_chars.contains(ch) || (ch == EOF))
+        if (text[1] == '-' || text[1] == '+')
         {
-            break;
+            return std::errc::invalid_argument;
         }
-        else
+        text.remove_prefix(1);
+    }
+    auto [end, result] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result == std::errc() && end != text.data() + text.size())
+    {
+        return std::errc::invalid_argument;
+    }
+    return result;
+}
+
+/**
+ * Whether a parsed value is outside the range of the narrower type it is stored as
+ */
+template <class T>
+static bool out_of_limits(T value, T min_value, T max_value)
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < min_value)
         {
-            get_char();
-            if (ch == '\\')
-            {
-                ch = get_char();
-                if (ch == EOF)
-                {
-                    error += "\nUnexpected EOF after backslash at line " + std::to_string(line_number);
-                    return res;
-                }
-                res += escapes.contains(ch) ? escapes.at(ch) : "\\" + std::string(1, ch);
-            }
-            else
-            {
-                res += ch;
-            }
+            return true;
+        }
+    }
+    return value > max_value;
+}
+
+/**
+ * An optional sign followed by decimal digits only
+ */
+static bool is_integer(std::string_view text)
+{
+    size_t i = (text[0] == '-' || text[0] == '+') ? 1 : 0;
+    if (i == text.size())
+    {
+        return false;
+    }
+    for (; i < text.size(); i++)
+    {
+        if (text[i] < '0' || text[i] > '9')
+        {
+            return false;
         }
     }
-    return res;
+    return true;
 }
 
 static bool char_is_alpha(char ch)
@@ -114,21 +179,21 @@ static bool char_is_num(char ch)
     return (ch >= '0') && (ch <= '9');
 }
 
-std::string SinParser::read_var_name()
+std::string_view SinParser::read_var_name()
 {
     skip_whitespace();
-    if (ss.eof())
+    if (eof())
     {
         error += "\nReading variable name: EOF at line: " + std::to_string(line_number);
         return {};
     }
-    int ch = ss.peek();
+    int ch = peek_char();
     if (ch == '[')
     {
         get_char(); // [
         skip_whitespace();
-        std::string res;
-        ch = ss.peek();
+        std::string_view res;
+        ch = peek_char();
         if ((ch == '`') || (ch == '"'))
         {
             res = read_string();
@@ -136,7 +201,7 @@ std::string SinParser::read_var_name()
         }
         else
         {
-            res = read_till_char({']'});
+            res = read_till_char(SIN_CHAR_INDEX_END);
         }
         ch = get_char();
         if (ch != ']')
@@ -148,7 +213,7 @@ std::string SinParser::read_var_name()
     else if (ch == '.')
     {
         get_char(); // .
-        return read_till_char(whitespace_or_colon);
+        return read_till_char(SIN_CHAR_NAME_END);
     }
     else
     {
@@ -157,45 +222,42 @@ std::string SinParser::read_var_name()
     }
 }
 
-std::string SinParser::read_var_type()
+std::string_view SinParser::read_var_type()
 {
     skip_whitespace();
-    if (ss.eof())
+    if (eof())
     {
         error += "\nReading variable type: EOF at line: " + std::to_string(line_number);
         return {};
     }
-    return read_till_char(whitespace);
+    return read_till_char(SIN_CHAR_WHITESPACE);
 }
 
-std::string SinParser::read_number()
+std::string_view SinParser::read_number()
 {
     skip_whitespace();
-    auto delimiters = whitespace;
-    delimiters.insert(':');
-    delimiters.insert('}');
-    return read_till_char(delimiters);
+    return read_till_char(SIN_CHAR_NUMBER_END);
 }
 
-std::string SinParser::read_string()
+std::string_view SinParser::read_string()
 {
     int ch = get_char();
     if (ch == '\"')
     {
-        std::string value = read_till_char_with_escape({'"'}, {{'n', "\n"}, {'"', "\""}, {'r', "\r"}, {'t', "\t"}, {'\\', "\\"}});
+        std::string_view value = read_till_char_with_escape('"', sinQuoteEscapes);
         get_char(); // closing "
         return value;
     }
     else if (ch == '`')
     {
-        std::string value = read_till_char_with_escape({'`'}, {{'`', "`"}, {'\\', "\\"}});
+        std::string_view value = read_till_char_with_escape('`', sinBacktickEscapes);
         if (value.size() && value[0] == '\n')
         {
-            value.erase(value.begin());
+            value.remove_prefix(1);
         }
-        if (value.size() && *value.rbegin() == '\n')
+        if (value.size() && value.back() == '\n')
         {
-            value.pop_back();
+            value.remove_suffix(1);
         }
         get_char(); // closing `
         return value;
@@ -207,251 +269,500 @@ std::string SinParser::read_string()
     }
 }
 
-Sin SinParser::read_sin_value()
+int SinParser::read_value_start()
 {
     skip_whitespace();
-    if (ss.eof())
+    if (eof())
     {
         error += "\nEOF while reading SIN value at line " + std::to_string(line_number);
-        return {};
+        return EOF;
     }
 
     int ch = get_char();
     if (ch == EOF)
     {
         error += "\n':' expected but EOF encountered at line " + std::to_string(line_number);
-        return {};
+        return EOF;
     }
     if (ch != ':')
     {
         error += std::string("\n':' expected but ") + (char)ch + " encountered at line " + std::to_string(line_number);
-        return {};
+        return EOF;
     }
     skip_whitespace();
 
-    ch = ss.peek();
+    ch = peek_char();
     if (ch == EOF)
     {
         error += "\nUnexpected EOF encountered at line " + std::to_string(line_number);
-        return {};
     }
-    else if ((ch == '\"') || (ch == '`'))
+    return ch;
+}
+
+Sin SinParser::read_sin_value()
+{
+    SinTreeBuilder builder(resource);
+    read_value(builder);
+    return builder.result();
+}
+
+/**
+ * Reads an untyped number, a bool or a type name and its value
+ */
+bool SinParser::read_scalar(SinSaxScalar &scalar)
+{
+    std::string_view sin_type = read_var_type();
+    scalar.text = sin_type;
+    if (sin_type == "false" || sin_type == "true")
     {
-        return read_string();
+        scalar.type = SinType::Bool;
+        scalar.value.Bool = sin_type == "true";
+        return true;
     }
-    else if (char_is_alpha(ch) || char_is_num(ch) || (ch == '-') || (ch == '+'))
+    if (sin_type == "")
     {
-        std::string sin_type = read_var_type();
-        if (sin_type == "false")
+        error += "\ntype is empty at line " + std::to_string(line_number);
+        return false;
+    }
+
+    // if it looks like a number, classify it by its characters:
+    // integers become Int32, Int64 or Uint64, anything else is a Double
+    if (sinCharIs(sin_type[0], SIN_CHAR_NUMBER_START))
+    {
+        if (is_integer(sin_type))
         {
-            return false;
+            int64_t integer;
+            if (parse_number(sin_type, integer) == std::errc())
+            {
+                if (integer >= INT32_MIN && integer <= INT32_MAX)
+                {
+                    scalar.type = SinType::Int32;
+                    scalar.value.Int32 = static_cast<int32_t>(integer);
+                    return true;
+                }
+                scalar.type = SinType::Int64;
+                scalar.value.Int64 = integer;
+                return true;
+            }
+            uint64_t unsigned_integer;
+            if (parse_number(sin_type, unsigned_integer) == std::errc())
+            {
+                scalar.type = SinType::Uint64;
+                scalar.value.Uint64 = unsigned_integer;
+                return true;
+            }
         }
-        if (sin_type == "true")
+
+        double floating;
+        if (parse_number(sin_type, floating) == std::errc())
         {
+            scalar.type = SinType::Double;
+            scalar.value.Double = floating;
             return true;
         }
-        if (sin_type == "")
+
+        error += "\nCannot parse number: '" + std::string(sin_type) + "' at line " + std::to_string(line_number);
+        return false;
+    }
+
+    skip_whitespace();
+    std::string_view sin_value = read_number();
+    scalar.text = sin_value;
+
+    if (sin_value == "")
+    {
+        error += "\nNumber is empty at line " + std::to_string(line_number);
+        return false;
+    }
+
+    // Unsigned numbers starting with '-' are not valid
+    if (sin_type[0] == 'U' && sin_value[0] == '-')
+    {
+        error += std::string("\nOut of bounds. Can't parse '") + std::string(sin_value) + "' at line " + std::to_string(line_number);
+        return false;
+    }
+
+    if (sin_type == "Bool")
+    {
+        if (sin_value == "false" || sin_value == "true")
         {
-            error += "\ntype is empty at line " + std::to_string(line_number);
-            return {};
+            scalar.type = SinType::Bool;
+            scalar.value.Bool = sin_value == "true";
+            return true;
         }
+        error += "\nInvalid boolean value: " + std::string(sin_value) + " at line " + std::to_string(line_number);
+        return false;
+    }
+#define PARSE_NUMBER(SIN_TYPE, STANDARD_TYPE, PARSED_TYPE, CHECK_LIMIT, MIN_VALUE, MAX_VALUE)                                                 \
+    else if (sin_type == #SIN_TYPE)                                                                                                           \
+    {                                                                                                                                         \
+        PARSED_TYPE value;                                                                                                                    \
+        auto result = parse_number(sin_value, value);                                                                                         \
+        if (result == std::errc::result_out_of_range || (result == std::errc() && CHECK_LIMIT && out_of_limits<PARSED_TYPE>(value, MIN_VALUE, MAX_VALUE))) \
+        {                                                                                                                                     \
+            error += std::string("\nOut of bounds. Can't parse '") + std::string(sin_value) + "' at line " + std::to_string(line_number);     \
+            return false;                                                                                                                     \
+        }                                                                                                                                     \
+        if (result != std::errc())                                                                                                            \
+        {                                                                                                                                     \
+            error += std::string("\nInvalid number. Can't parse '") + std::string(sin_value) + "' at line " + std::to_string(line_number);    \
+            return false;                                                                                                                     \
+        }                                                                                                                                     \
+        scalar.type = SinType::SIN_TYPE;                                                                                                      \
+        scalar.value.SIN_TYPE = (STANDARD_TYPE)value;                                                                                         \
+        return true;                                                                                                                          \
+    }
 
-        // if it looks like a number
-        // try to parse as integer, then as double
-        static std::set<char> first_char_of_number = {'-', '+', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
-        if (first_char_of_number.contains(sin_type[0]))
+    PARSE_NUMBER(Int8, int8_t, int64_t, true, -0x80ll, 0x7Fll)
+    PARSE_NUMBER(Int16, int16_t, int64_t, true, -0x8000ll, 0x7FFFll)
+    PARSE_NUMBER(Int32, int32_t, int64_t, true, -0x80000000ll, 0x7FFFFFFFll)
+    PARSE_NUMBER(Int64, int64_t, int64_t, false, 0, 0)
+
+    PARSE_NUMBER(Uint8, uint8_t, uint64_t, true, 0, 0xFFull)
+    PARSE_NUMBER(Uint16, uint16_t, uint64_t, true, 0, 0xFFFFull)
+    PARSE_NUMBER(Uint32, uint32_t, uint64_t, true, 0, 0xFFFFFFFFull)
+    PARSE_NUMBER(Uint64, uint64_t, uint64_t, false, 0, 0)
+
+    PARSE_NUMBER(Float, float, float, false, 0, 0)
+    PARSE_NUMBER(Double, double, double, false, 0, 0)
+
+    else
+    {
+        error += "\nUnsupported type: " + std::string(sin_type) + " at line " + std::to_string(line_number);
+        return false;
+    }
+}
+
+bool SinParser::read_value(SinSaxHandler &handler)
+{
+    int ch = read_value_start();
+    if (ch == EOF)
+    {
+        return true;
+    }
+    else if ((ch == '\"') || (ch == '`'))
+    {
+        std::string_view text = read_string();
+        SinSaxScalar scalar;
+        scalar.type = SinType::String;
+        scalar.text = text;
+        return handler.onScalar(scalar) != SinSaxAction::Stop;
+    }
+    else if (char_is_alpha(ch) || char_is_num(ch) || (ch == '-') || (ch == '+'))
+    {
+        SinSaxScalar scalar;
+        if (!read_scalar(scalar))
+        {
+            return true;
+        }
+        return handler.onScalar(scalar) != SinSaxAction::Stop;
+    }
+    else if ((ch == '{') || (ch == '['))
+    {
+        get_char();
+        auto action = ch == '{' ? handler.onObjectBegin() : handler.onArrayBegin();
+        if (action == SinSaxAction::Stop)
+        {
+            return false;
+        }
+        if (action == SinSaxAction::Skip)
         {
-#define PARSE_NUMBER_TYPE_NOT_SPECIFIED(STANDARD_TYPE, CONVERTER)    \
-    try                                                              \
-    {                                                                \
-        size_t end_of_var;                                           \
-        STANDARD_TYPE value = std::CONVERTER(sin_type, &end_of_var); \
-        if (end_of_var != sin_type.size())                           \
-        {                                                            \
-            throw std::runtime_error("not parsed");                  \
-        }                                                            \
-        return value;                                                \
-    }                                                                \
-    catch (...)                                                      \
-    {                                                                \
-    }
-
-            PARSE_NUMBER_TYPE_NOT_SPECIFIED(int, stoi);
-            PARSE_NUMBER_TYPE_NOT_SPECIFIED(int64_t, stoll);
-            PARSE_NUMBER_TYPE_NOT_SPECIFIED(uint64_t, stoull);
-            PARSE_NUMBER_TYPE_NOT_SPECIFIED(double, stod);
-
-            error += "\nCannot parse number: '" + sin_type + "' at line " + std::to_string(line_number);
-            return {};
+            skip_container();
+            return true;
         }
+        return ch == '{' ? read_object(handler) : read_array(handler);
+    }
+    else
+    {
+        error += std::string("\nUnexpected characted '") + (char)ch + "' encountered at line " + std::to_string(line_number);
+        return true;
+    }
+}
 
+SinParser::Entry SinParser::read_object_key(std::string &name)
+{
+    skip_whitespace();
+    int ch = peek_char();
+    if (ch == EOF)
+    {
+        error += "\nEOF at line " + std::to_string(line_number);
+        return Entry::End;
+    }
+    else if ((ch == '.') || (ch == '['))
+    {
+        name = read_var_name();
         skip_whitespace();
-        std::string sin_value = read_number();
+        return Entry::Value;
+    }
+    else if (ch == '}')
+    {
+        get_char(); // }
+        return Entry::End;
+    }
+    else
+    {
+        error += std::string("\nUnexpected characted '") + (char)ch + "' encountered at line " + std::to_string(line_number);
+        return Entry::End;
+    }
+}
 
-        if (sin_value == "")
+SinParser::Entry SinParser::read_array_index(int32_t &index)
+{
+    skip_whitespace();
+    int ch = peek_char();
+    if (ch == EOF)
+    {
+        error += "\nEOF at line " + std::to_string(line_number);
+        return Entry::End;
+    }
+    else if ((ch == '.') || (ch == '['))
+    {
+        std::string_view name = read_var_name();
+        if (parse_number(name, index) != std::errc() || index < 0)
         {
-            error += "\nNumber is empty at line " + std::to_string(line_number);
-            return {};
+            error += "\nInvalid array index: '" + std::string(name) + "' at line " + std::to_string(line_number);
+            return Entry::End;
         }
+        skip_whitespace();
+        return Entry::Value;
+    }
+    else if (ch == ']')
+    {
+        get_char(); // ]
+        return Entry::End;
+    }
+    else
+    {
+        error += std::string("\nUnexpected characted '") + (char)ch + "' encountered at line " + std::to_string(line_number);
+        return Entry::End;
+    }
+}
 
-        // Unsigned numbers starting with '-' are not valid
-        if (sin_type[0] == 'U' && sin_value[0] == '-')
+bool SinParser::read_entry_value(SinSaxAction action, SinSaxHandler &handler)
+{
+    if (action == SinSaxAction::Stop)
+    {
+        return false;
+    }
+    if (action == SinSaxAction::Skip)
+    {
+        skip_value();
+        return true;
+    }
+    return read_value(handler);
+}
+
+bool SinParser::read_object(SinSaxHandler &handler)
+{
+    // handlers take the key in onKey, so nested objects can reuse the buffer
+    while (read_object_key(key_buffer) == Entry::Value)
+    {
+        if (!read_entry_value(handler.onKey(key_buffer), handler))
         {
-            error += std::string("\nOut of bounds. Can't parse '") + sin_value + "' at line " + std::to_string(line_number);
-            return {};
+            return false;
         }
+    }
+    return handler.onEnd() != SinSaxAction::Stop;
+}
 
-        if (sin_type == "Bool")
+bool SinParser::read_array(SinSaxHandler &handler)
+{
+    int32_t index;
+    while (read_array_index(index) == Entry::Value)
+    {
+        if (!read_entry_value(handler.onArrayIndex(size_t(index)), handler))
         {
-            if (sin_value == "false")
-            {
-                return false;
-            }
-            if (sin_value == "true")
-            {
-                return true;
-            }
-            error += "\nInvalid boolean value: " + sin_value + " at line " + std::to_string(line_number);
-            return {};
+            return false;
         }
-#define PARSE_NUMBER(SIN_TYPE, STANDARD_TYPE, CONVERTER, CHECK_LIMIT, MIN_VALUE, MAX_VALUE)                                      \
-    else if (sin_type == #SIN_TYPE)                                                                                              \
-    {                                                                                                                            \
-        try                                                                                                                      \
-        {                                                                                                                        \
-            auto value = std::CONVERTER(sin_value);                                                                              \
-            if (CHECK_LIMIT && (value < MIN_VALUE || value > MAX_VALUE))                                                         \
-            {                                                                                                                    \
-                error += std::string("\nOut of bounds. Can't parse '") + sin_value + "' at line " + std::to_string(line_number); \
-                return {};                                                                                                       \
-            }                                                                                                                    \
-            return (STANDARD_TYPE)value;                                                                                         \
-        }                                                                                                                        \
-        catch (std::exception & e)                                                                                               \
-        {                                                                                                                        \
-            error += std::string("\n") + e.what() + ". Can't parse '" + sin_value + "' at line " + std::to_string(line_number);  \
-            return {};                                                                                                           \
-        }                                                                                                                        \
-    }
-
-        PARSE_NUMBER(Int8, int8_t, stoll, true, -0x80ll, 0x7Fll)
-        PARSE_NUMBER(Int16, int16_t, stoll, true, -0x8000ll, 0x7FFFll)
-        PARSE_NUMBER(Int32, int32_t, stoll, true, -0x80000000ll, 0x7FFFFFFFll)
-        PARSE_NUMBER(Int64, int64_t, stoll, false, 0, 0)
-
-        PARSE_NUMBER(Uint8, uint8_t, stoull, true, 0, 0xFFull)
-        PARSE_NUMBER(Uint16, uint16_t, stoull, true, 0, 0xFFFFull)
-        PARSE_NUMBER(Uint32, uint32_t, stoull, true, 0, 0xFFFFFFFFull)
-        PARSE_NUMBER(Uint64, uint64_t, stoull, false, 0, 0)
-
-        PARSE_NUMBER(Float, float, stof, false, 0, 0)
-        PARSE_NUMBER(Double, double, stod, false, 0, 0)
+    }
+    return handler.onEnd() != SinSaxAction::Stop;
+}
 
-        else
+SinParser::Entry SinParser::read_object_entry(std::string &name, Sin &value)
+{
+    Entry entry = read_object_key(name);
+    if (entry == Entry::Value)
+    {
+        value = read_sin_value();
+    }
+    return entry;
+}
+
+SinParser::Entry SinParser::read_array_entry(int32_t &index, Sin &value)
+{
+    Entry entry = read_array_index(index);
+    if (entry == Entry::Value)
+    {
+        value = read_sin_value();
+    }
+    return entry;
+}
+
+Sin SinParser::read_container(Sin container)
+{
+    SinTreeBuilder builder(resource);
+    bool object = container.typeId() == SinType::Object;
+    builder.resume(std::move(container));
+    if (object)
+    {
+        read_object(builder);
+    }
+    else
+    {
+        read_array(builder);
+    }
+    return builder.result();
+}
+
+void SinParser::skip_string()
+{
+    char quote = input[pos++];
+    while (true)
+    {
+        pos += scan.findStringStop(input.data() + pos, input.size() - pos, quote, &line_number);
+        if (eof())
         {
-            error += "\nUnsupported type: " + sin_type + " at line " + std::to_string(line_number);
-            return {};
+            return;
         }
+        if (input[pos++] == quote)
+        {
+            return;
+        }
+        get_char(); // escaped character
     }
-    else if (ch == '{')
+}
+
+void SinParser::skip_container()
+{
+    size_t depth = 1;
+    while (true)
     {
-        get_char();
-        Sin sin;
-        while (true)
+        read_till_char(SIN_CHAR_STRUCTURE);
+        int ch = peek_char();
+        if (ch == EOF)
         {
-            skip_whitespace();
-            int ch2 = ss.peek();
-            if (ch2 == EOF)
-            {
-                error += "\nEOF at line " + std::to_string(line_number);
-                return sin;
-            }
-            else if ((ch2 == '.') || (ch2 == '['))
-            {
-                auto name = read_var_name();
-                skip_whitespace();
-                Sin value = read_sin_value();
-                sin[name] = value;
-            }
-            else if (ch2 == '}')
+            error += "\nEOF at line " + std::to_string(line_number);
+            return;
+        }
+        if ((ch == '"') || (ch == '`'))
+        {
+            skip_string();
+        }
+        else if (ch == '.')
+        {
+            // names may contain brackets and quotes
+            get_char();
+            read_till_char(SIN_CHAR_NAME_END);
+        }
+        else
+        {
+            get_char();
+            if ((ch == '{') || (ch == '['))
             {
-                get_char(); // }
-                return sin;
+                depth++;
             }
-            else
+            else if (--depth == 0)
             {
-                error += std::string("\nUnexpected characted '") + (char)ch2 + "' encountered at line " + std::to_string(line_number);
-                return sin;
+                return;
             }
         }
     }
-    else if (ch == '[')
+}
+
+void SinParser::skip_value()
+{
+    int ch = read_value_start();
+    if (ch != EOF)
+    {
+        skip_value_after_start(ch);
+    }
+}
+
+void SinParser::skip_value_after_start(int ch)
+{
+    if ((ch == '"') || (ch == '`'))
+    {
+        skip_string();
+    }
+    else if ((ch == '{') || (ch == '['))
     {
         get_char();
-        Sin sin = Sin::Array();
-        while (true)
-        {
-            skip_whitespace();
-            int ch2 = ss.peek();
-            if (ch2 == EOF)
-            {
-                error += "\nEOF at line " + std::to_string(line_number);
-                return sin;
-            }
-            else if ((ch2 == '.') || (ch2 == '['))
-            {
-                auto name = read_var_name();
-                int32_t index;
-                try
-                {
-                    size_t end_of_int;
-                    index = std::stoi(name, &end_of_int);
-                    if (end_of_int != name.size())
-                    {
-                        throw std::invalid_argument("Extra characters");
-                    }
-                    if (index < 0)
-                    {
-                        throw new std::invalid_argument("Index < 0");
-                    }
-                }
-                catch (std::invalid_argument &e)
-                {
-                    error += std::string("\n") + e.what() + ". Invalid array index: '" + name + "' at line " + std::to_string(line_number);
-                    return {};
-                }
-                skip_whitespace();
-                Sin value = read_sin_value();
-                sin[index] = value;
-            }
-            else if (ch2 == ']')
-            {
-                get_char(); // ]
-                return sin;
-            }
-            else
-            {
-                error += std::string("\nUnexpected characted '") + (char)ch2 + "' encountered at line " + std::to_string(line_number);
-                return sin;
-            }
-        }
-        return sin;
+        skip_container();
     }
     else
     {
-        error += std::string("\nUnexpected characted '") + (char)ch + "' encountered at line " + std::to_string(line_number);
-        return {};
+        std::string_view token = read_var_type();
+        if (!token.empty() && !sinCharIs(token[0], SIN_CHAR_NUMBER_START) && token != "true" && token != "false")
+        {
+            // typed value
+            read_number();
+        }
     }
 }
 
-SinParser::SinParser(const std::string &str) : ss(str)
+SinParser::SinParser(std::string_view str, std::pmr::memory_resource *resource) : resource(resource), input(str)
 {
     value = read_sin_value();
 }
 
-Sin parseSin(const std::string &str)
+SinParser::SinParser(std::string_view str, SinSaxHandler &handler) : resource(std::pmr::get_default_resource()), input(str)
+{
+    read_value(handler);
+}
+
+SinParser::SinParser(std::string_view str, std::pmr::memory_resource *resource, size_t first_line) : line_number(first_line), resource(resource), input(str)
+{
+}
+
+SinParser::SinParser() : resource(std::pmr::get_default_resource())
+{
+}
+
+void SinParser::reset(std::string_view str, std::pmr::memory_resource *resource)
+{
+    this->resource = resource;
+    input = str;
+    pos = 0;
+    line_number = 0;
+    error.clear();
+}
+
+void SinParser::throw_error() const
+{
+    if (!error.empty())
+    {
+        throw std::invalid_argument("Can't parse configuration: " + error);
+    }
+}
+
+Sin SinParser::read_piece(std::string_view str, std::pmr::memory_resource *resource, size_t first_line)
+{
+    reset(str, resource);
+    line_number = first_line;
+    builder.reset(resource);
+    read_value(builder);
+    return builder.result();
+}
+
+Sin SinParser::parse(std::string_view str, std::pmr::memory_resource *resource)
+{
+    reset(str, resource);
+    builder.reset(resource);
+    read_value(builder);
+    throw_error();
+    return builder.result();
+}
+
+void SinParser::parse(std::string_view str, SinSaxHandler &handler)
 {
-    auto parser = SinParser(str);
+    reset(str, std::pmr::get_default_resource());
+    read_value(handler);
+    throw_error();
+}
+
+Sin parseSin(std::string_view str, std::pmr::memory_resource *resource)
+{
+    auto parser = SinParser(str, resource);
 
     if (parser.error != "") {
         std::string error = "Can't parse configuration: " + parser.error;
@@ -459,4 +770,14 @@ Sin parseSin(const std::string &str)
     }
 
     return parser.value;
+}
+
+void parseSin(std::string_view str, SinSaxHandler &handler)
+{
+    auto parser = SinParser(str, handler);
+
+    if (parser.error != "")
+    {
+        throw std::invalid_argument("Can't parse configuration: " + parser.error);
+    }
 }
\ No newline at end of file
@@ -1,5 +1,25 @@
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 #include "sin.h"
+#include "sin_sax.h"
 
-Sin parseSin(const std::string &str);
\ No newline at end of file
+Sin parseSin(std::string_view str, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/**
+ * Reports the document to the handler without building a tree,
+ * throws std::invalid_argument like parseSin
+ */
+void parseSin(std::string_view str, SinSaxHandler &handler);
+
+/**
+ * Parses the entries of the root object or array on `threads` threads,
+ * 0 uses one per core and is plain parseSin on a single core. An explicit
+ * 1 runs the pre-scan and the entries on the calling thread, which only
+ * shows what the split costs. The result and any error are the same as parseSin
+ * gives; a document with an error is parsed again sequentially to report
+ * it. resource is used from all threads, so it must be thread-safe,
+ * which the default resource is and a SinArena is not.
+ */
+Sin parseSinParallel(std::string_view str, unsigned threads = 0, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
@@ -1,31 +1,144 @@
 #include "sin.h"
+#include "sin_sax.h"
+#include "sin_scan.h"
 
-#include <set>
-#include <sstream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
 
 class SinParser
 {
 public:
-    SinParser(const std::string &str);
+    SinParser(std::string_view str, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
     Sin value;
     std::string error;
 
+    /**
+     * Reports the document to the handler instead of building value
+     */
+    SinParser(std::string_view str, SinSaxHandler &handler);
+
+    /**
+     * A parser for many documents in turn, e.g. messages in a loop. It keeps
+     * its buffers, the builder's stacks and the keys it has interned from one
+     * parse() to the next, so a steady stream of similar documents stops
+     * allocating anything but the trees.
+     *
+     * Not thread-safe: use one instance per thread.
+     */
+    SinParser();
+
+    /**
+     * Same result and errors as parseSin, value is not set
+     */
+    Sin parse(std::string_view str, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    void parse(std::string_view str, SinSaxHandler &handler);
+
 private:
+    friend class SinStreamParser;
+    friend class SinLazyDocument;
+    friend Sin parseSinParallel(std::string_view str, unsigned threads, std::pmr::memory_resource *resource);
+
+    /**
+     * Cursor over a piece of a larger document, nothing is parsed yet
+     */
+    SinParser(std::string_view str, std::pmr::memory_resource *resource, size_t first_line);
+
     size_t line_number = 0;
-    std::stringstream ss;
 
     /**
-     * A wrapper around std::stringsteam::get() to implement line counter
+     * Containers and strings of the parsed tree are allocated from here
+     */
+    std::pmr::memory_resource *resource;
+
+    /**
+     * The parser never owns or copies the input, it only moves a cursor over it.
+     * Tokens are returned as views into the input until a value is built.
+     */
+    std::string_view input;
+    size_t pos = 0;
+
+    const SinScanKernels &scan = sinScanKernels();
+
+    /**
+     * Decoded strings that could not be views into the input, and the key
+     * of the entry read_object is at
+     */
+    std::string string_buffer;
+    std::string key_buffer;
+
+    SinTreeBuilder builder;
+
+    void reset(std::string_view str, std::pmr::memory_resource *resource);
+    void throw_error() const;
+
+    /**
+     * Parses one value that starts at first_line of a larger document with
+     * the reused builder, leaves the cursor after it
+     */
+    Sin read_piece(std::string_view str, std::pmr::memory_resource *resource, size_t first_line);
+
+    bool eof() const;
+    int peek_char() const;
+    /**
+     * Consumes a character and keeps the line counter up to date
      */
     int get_char();
-    void skip_chars(const std::set<char> &chars);
     void skip_whitespace();
-    std::string read_till_char(const std::set<char> &chars);
-    std::string read_till_char_with_escape(const std::set<char> &terminating_chars, const std::map<char, std::string> &escapes);
-    std::string read_number();
+    std::string_view read_till_char(uint8_t classes);
+    std::string_view read_till_char_with_escape(char terminating_char, const SinEscapeTable &escapes);
+    std::string_view read_number();
+
+    /**
+     * Reads up to the first character of a value after its ':',
+     * returns EOF with the error set if there is none
+     */
+    int read_value_start();
+    bool read_scalar(SinSaxScalar &scalar);
 
+    /**
+     * Emits the events of one value, returns false once the handler stops the parse
+     */
+    bool read_value(SinSaxHandler &handler);
     Sin read_sin_value();
-    std::string read_var_name();
-    std::string read_var_type();
-    std::string read_string();
+
+    /**
+     * Containers are read one entry at a time, the stream parser
+     * resumes them between chunks
+     */
+    enum class Entry
+    {
+        // the key of an entry was read, its value follows
+        Value,
+        // the closing bracket or an error that ends the container
+        End,
+    };
+    Entry read_object_key(std::string &name);
+    Entry read_array_index(int32_t &index);
+    bool read_entry_value(SinSaxAction action, SinSaxHandler &handler);
+    bool read_object(SinSaxHandler &handler);
+    bool read_array(SinSaxHandler &handler);
+
+    Entry read_object_entry(std::string &name, Sin &value);
+    Entry read_array_entry(int32_t &index, Sin &value);
+
+    /**
+     * Reads the remaining entries of an object or array that was started earlier
+     */
+    Sin read_container(Sin container);
+
+    /**
+     * Fast-forward over skipped values without decoding them
+     */
+    void skip_string();
+    void skip_container();
+    void skip_value();
+    void skip_value_after_start(int ch);
+
+    /**
+     * Views into the input, or into string_buffer until the next string is read
+     */
+    std::string_view read_var_name();
+    std::string_view read_var_type();
+    std::string_view read_string();
 };
@@ -0,0 +1,219 @@
+#include "sin_sax.h"
+
+#include <algorithm>
+#include <utility>
+
+SinTreeBuilder::SinTreeBuilder(std::pmr::memory_resource *resource) : _resource(resource)
+{
+}
+
+void SinTreeBuilder::reset(std::pmr::memory_resource *resource)
+{
+    // documents with generated keys would otherwise keep all of them alive
+    static constexpr size_t KEYS_KEPT = 4096;
+
+    _resource = resource;
+    _stack.clear();
+    _root = Sin();
+    for (auto &members : _members)
+    {
+        members.clear();
+    }
+    for (auto &elements : _elements)
+    {
+        elements.clear();
+    }
+    if (_keys.size() > KEYS_KEPT)
+    {
+        _keys.clear();
+    }
+}
+
+void SinTreeBuilder::resume(Sin container)
+{
+    _stack.push_back(Frame(std::move(container)));
+    openFrame();
+}
+
+void SinTreeBuilder::openFrame()
+{
+    if (_members.size() < _stack.size())
+    {
+        _members.resize(_stack.size());
+        _elements.resize(_stack.size());
+    }
+}
+
+void SinTreeBuilder::addMember(Sin &object, std::string_view key, Sin value)
+{
+    object.asObject().insert_or_assign(key, std::move(value));
+}
+
+void SinTreeBuilder::addElement(Sin &array, size_t index, Sin value)
+{
+    auto &elements = array.asArray();
+    if (index >= elements.size())
+    {
+        elements.resize(index, Sin::Undefined());
+        elements.push_back(std::move(value));
+    }
+    else
+    {
+        elements[index] = std::move(value);
+    }
+}
+
+void SinTreeBuilder::packArray(Sin &array)
+{
+    // the non-const asArray() would unpack a packed array only to pack it again
+    if (array.packedType() == SinType::Undefined && array.size() >= PACK_MIN)
+    {
+        array.pack();
+    }
+}
+
+Sin SinTreeBuilder::toSin(const SinSaxScalar &scalar, std::pmr::memory_resource *resource)
+{
+    if (scalar.type == SinType::String)
+    {
+        return Sin(scalar.text, resource);
+    }
+    Sin value;
+    visitSinScalar(scalar.type, scalar.value, [&value](auto number)
+                   { value = number; });
+    return value;
+}
+
+void SinTreeBuilder::add(Sin value)
+{
+    if (_stack.empty())
+    {
+        _root = std::move(value);
+        return;
+    }
+
+    Frame &frame = _stack.back();
+    if (!frame.hasEntry)
+    {
+        return;
+    }
+    frame.hasEntry = false;
+
+    if (frame.container.typeId() == SinType::Object)
+    {
+        _members[_stack.size() - 1].emplace_back(std::move(frame.key), std::move(value));
+    }
+    else
+    {
+        // elements in order go straight in, the others wait for onEnd
+        auto &pending = _elements[_stack.size() - 1];
+        auto &array = frame.container.asArray();
+        if (pending.empty() && frame.index == array.size())
+        {
+            array.push_back(std::move(value));
+        }
+        else
+        {
+            pending.emplace_back(frame.index, std::move(value));
+        }
+    }
+}
+
+/**
+ * A value that failed to parse has no events, its entry gets
+ * an empty value like Sin::parse has always given it
+ */
+void SinTreeBuilder::addMissingValue()
+{
+    if (!_stack.empty() && _stack.back().hasEntry)
+    {
+        add({});
+    }
+}
+
+SinSaxAction SinTreeBuilder::onObjectBegin()
+{
+    _stack.push_back(Frame(Sin::Object(_resource)));
+    openFrame();
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinTreeBuilder::onArrayBegin()
+{
+    _stack.push_back(Frame(Sin::Array(_resource)));
+    openFrame();
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinTreeBuilder::onKey(std::string_view key)
+{
+    addMissingValue();
+    Frame &frame = _stack.back();
+    frame.key = _keys.get(key);
+    frame.hasEntry = true;
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinTreeBuilder::onArrayIndex(size_t index)
+{
+    addMissingValue();
+    Frame &frame = _stack.back();
+    frame.index = index;
+    frame.hasEntry = true;
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinTreeBuilder::onScalar(const SinSaxScalar &scalar)
+{
+    add(toSin(scalar, _resource));
+    return SinSaxAction::Continue;
+}
+
+SinSaxAction SinTreeBuilder::onEnd()
+{
+    addMissingValue();
+    Sin container = std::move(_stack.back().container);
+    _stack.pop_back();
+    if (container.typeId() == SinType::Object)
+    {
+        // members go in at once, in key order
+        auto &members = _members[_stack.size()];
+        auto &object = container.asObject();
+        object.reserve(object.size() + members.size());
+        for (auto &[key, value] : members)
+        {
+            object.appendUnsorted(std::move(key), std::move(value));
+        }
+        object.sortKeys();
+        members.clear();
+    }
+    else
+    {
+        // one allocation at the final size for the elements out of order
+        auto &elements = _elements[_stack.size()];
+        auto &array = container.asArray();
+        size_t size = array.size();
+        for (const auto &element : elements)
+        {
+            size = std::max(size, element.first + 1);
+        }
+        array.resize(size, Sin::Undefined());
+        for (auto &[index, value] : elements)
+        {
+            array[index] = std::move(value);
+        }
+        elements.clear();
+        packArray(container);
+    }
+    add(std::move(container));
+    return SinSaxAction::Continue;
+}
+
+Sin SinTreeBuilder::result()
+{
+    while (!_stack.empty())
+    {
+        onEnd();
+    }
+    return std::move(_root);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sin.h"
+
+/**
+ * What the parser does after an event
+ */
+enum class SinSaxAction
+{
+    Continue,
+    // after onKey/onArrayIndex: skip the value of the entry,
+    // after onObjectBegin/onArrayBegin: skip the rest of the container,
+    // there are no events for skipped input, not even onEnd
+    Skip,
+    // end the parse right away, without an error
+    Stop,
+};
+
+/**
+ * A scalar as the parser read it.
+ *
+ * For String, text is the decoded string. For numbers and bools text is
+ * the token from the document and value holds the converted number of
+ * the given type. text only lives until the handler returns.
+ */
+struct SinSaxScalar
+{
+    SinType type = SinType::Undefined;
+    std::string_view text;
+    SinScalar value{};
+};
+
+/**
+ * Events of the SIN grammar, in document order. Every value is either
+ * one onScalar or a container: onObjectBegin/onArrayBegin, an onKey or
+ * onArrayIndex before each entry's value, and onEnd. A value that fails
+ * to parse has no events, the error is reported by the parser. Like
+ * scalar text, a key only lives until the handler returns.
+ */
+class SinSaxHandler
+{
+public:
+    virtual ~SinSaxHandler() = default;
+
+    virtual SinSaxAction onObjectBegin() = 0;
+    virtual SinSaxAction onArrayBegin() = 0;
+    virtual SinSaxAction onKey(std::string_view key) = 0;
+    virtual SinSaxAction onArrayIndex(size_t index) = 0;
+    virtual SinSaxAction onScalar(const SinSaxScalar &scalar) = 0;
+    virtual SinSaxAction onEnd() = 0;
+};
+
+/**
+ * Handler that builds the regular Sin tree, which is what Sin::parse does
+ */
+class SinTreeBuilder : public SinSaxHandler
+{
+    struct Frame
+    {
+        Sin container;
+        SinKey key;
+        size_t index = 0;
+        bool hasEntry = false;
+
+        explicit Frame(Sin container) : container(std::move(container)) {}
+    };
+
+    std::pmr::memory_resource *_resource;
+    std::vector<Frame> _stack;
+    // members of the open objects and elements of the open arrays by
+    // depth, kept between containers so that each container is allocated
+    // once at its final size
+    std::vector<std::vector<std::pair<SinKey, Sin>>> _members;
+    std::vector<std::vector<std::pair<size_t, Sin>>> _elements;
+    // documents repeat their keys, each is interned once per parse
+    SinKeyCache _keys;
+    Sin _root;
+
+    void openFrame();
+    void add(Sin value);
+    void addMissingValue();
+
+public:
+    /**
+     * Arrays of numbers of one type with at least this many elements are packed, see Sin::pack
+     */
+    static constexpr size_t PACK_MIN = 16;
+
+    explicit SinTreeBuilder(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /**
+     * Starts a new tree from the given resource, keeping the buffers and
+     * the interned keys of the earlier ones
+     */
+    void reset(std::pmr::memory_resource *resource);
+
+    /**
+     * Continues filling an existing object or array, as if its begin event had been seen
+     */
+    void resume(Sin container);
+
+    /**
+     * The tree, containers that were not ended yet are closed as they are
+     */
+    Sin result();
+
+    /**
+     * A repeated key replaces the earlier value
+     */
+    static void addMember(Sin &object, std::string_view key, Sin value);
+
+    /**
+     * Indexes past the end leave holes of Sin::Undefined() in the array
+     */
+    static void addElement(Sin &array, size_t index, Sin value);
+
+    /**
+     * Packs an array the builder didn't end itself, like the ones it ends:
+     * when it has PACK_MIN or more numbers of one type. A packed array is
+     * left as it is.
+     */
+    static void packArray(Sin &array);
+
+    static Sin toSin(const SinSaxScalar &scalar, std::pmr::memory_resource *resource);
+
+    SinSaxAction onObjectBegin() override;
+    SinSaxAction onArrayBegin() override;
+    SinSaxAction onKey(std::string_view key) override;
+    SinSaxAction onArrayIndex(size_t index) override;
+    SinSaxAction onScalar(const SinSaxScalar &scalar) override;
+    SinSaxAction onEnd() override;
+};
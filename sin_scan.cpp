@@ -0,0 +1,186 @@
+#include "sin_scan.h"
+
+#include <bit>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIN_SCAN_X86
+#include <immintrin.h>
+#endif
+
+static size_t skipWhitespaceScalar(const char *data, size_t size, size_t *newlines)
+{
+    size_t i = 0;
+    while (i < size && sinCharIs(data[i], SIN_CHAR_WHITESPACE))
+    {
+        if (data[i] == '\n')
+        {
+            (*newlines)++;
+        }
+        i++;
+    }
+    return i;
+}
+
+static size_t findStringStopScalar(const char *data, size_t size, char quote, size_t *newlines)
+{
+    size_t i = 0;
+    while (i < size && data[i] != quote && data[i] != '\\')
+    {
+        if (data[i] == '\n')
+        {
+            (*newlines)++;
+        }
+        i++;
+    }
+    return i;
+}
+
+static const SinScanKernels scalarKernels = {"scalar", skipWhitespaceScalar, findStringStopScalar};
+
+#ifdef SIN_SCAN_X86
+
+// The vector kernels classify a whole block, then use the bit masks:
+// the first byte that ends the run is the lowest bit of the stop mask,
+// and the newlines before it are a popcount of the newline mask.
+
+__attribute__((target("sse2"))) static size_t skipWhitespaceSse2(const char *data, size_t size, size_t *newlines)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i isLf = _mm_cmpeq_epi8(block, lf);
+        __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(block, cr), isLf));
+        uint32_t lfMask = static_cast<uint32_t>(_mm_movemask_epi8(isLf));
+        uint32_t stopMask = ~static_cast<uint32_t>(_mm_movemask_epi8(isSpace)) & 0xFFFF;
+        if (stopMask)
+        {
+            int stop = std::countr_zero(stopMask);
+            *newlines += std::popcount(lfMask & ((1u << stop) - 1));
+            return i + stop;
+        }
+        *newlines += std::popcount(lfMask);
+    }
+    return i + skipWhitespaceScalar(data + i, size - i, newlines);
+}
+
+__attribute__((target("sse2"))) static size_t findStringStopSse2(const char *data, size_t size, char quote, size_t *newlines)
+{
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i isStop = _mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, backslash));
+        uint32_t lfMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, lf)));
+        uint32_t stopMask = static_cast<uint32_t>(_mm_movemask_epi8(isStop));
+        if (stopMask)
+        {
+            int stop = std::countr_zero(stopMask);
+            *newlines += std::popcount(lfMask & ((1u << stop) - 1));
+            return i + stop;
+        }
+        *newlines += std::popcount(lfMask);
+    }
+    return i + findStringStopScalar(data + i, size - i, quote, newlines);
+}
+
+__attribute__((target("avx2"))) static size_t skipWhitespaceAvx2(const char *data, size_t size, size_t *newlines)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i isLf = _mm256_cmpeq_epi8(block, lf);
+        __m256i isSpace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab)),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), isLf));
+        uint32_t lfMask = static_cast<uint32_t>(_mm256_movemask_epi8(isLf));
+        uint32_t stopMask = ~static_cast<uint32_t>(_mm256_movemask_epi8(isSpace));
+        if (stopMask)
+        {
+            int stop = std::countr_zero(stopMask);
+            *newlines += std::popcount(lfMask & ((uint64_t{1} << stop) - 1));
+            return i + stop;
+        }
+        *newlines += std::popcount(lfMask);
+    }
+    return i + skipWhitespaceSse2(data + i, size - i, newlines);
+}
+
+__attribute__((target("avx2"))) static size_t findStringStopAvx2(const char *data, size_t size, char quote, size_t *newlines)
+{
+    const __m256i quotes = _mm256_set1_epi8(quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i isStop = _mm256_or_si256(_mm256_cmpeq_epi8(block, quotes), _mm256_cmpeq_epi8(block, backslash));
+        uint32_t lfMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, lf)));
+        uint32_t stopMask = static_cast<uint32_t>(_mm256_movemask_epi8(isStop));
+        if (stopMask)
+        {
+            int stop = std::countr_zero(stopMask);
+            *newlines += std::popcount(lfMask & ((uint64_t{1} << stop) - 1));
+            return i + stop;
+        }
+        *newlines += std::popcount(lfMask);
+    }
+    return i + findStringStopSse2(data + i, size - i, quote, newlines);
+}
+
+static const SinScanKernels sse2Kernels = {"sse2", skipWhitespaceSse2, findStringStopSse2};
+static const SinScanKernels avx2Kernels = {"avx2", skipWhitespaceAvx2, findStringStopAvx2};
+
+#endif // SIN_SCAN_X86
+
+const SinScanKernels *sinScanKernelsFor(SinScanLevel level)
+{
+    switch (level)
+    {
+    case SinScanLevel::Scalar:
+        return &scalarKernels;
+#ifdef SIN_SCAN_X86
+    case SinScanLevel::SSE2:
+        return __builtin_cpu_supports("sse2") ? &sse2Kernels : nullptr;
+    case SinScanLevel::AVX2:
+        return __builtin_cpu_supports("avx2") ? &avx2Kernels : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+static const SinScanKernels &selectScanKernels()
+{
+    for (auto level : {SinScanLevel::AVX2, SinScanLevel::SSE2})
+    {
+        if (auto kernels = sinScanKernelsFor(level))
+        {
+            return *kernels;
+        }
+    }
+    return scalarKernels;
+}
+
+const SinScanKernels &sinScanKernels()
+{
+    static const SinScanKernels &kernels = selectScanKernels();
+    return kernels;
+}
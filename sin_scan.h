@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Character classes used by the parser. Each byte is classified with a
+ * single load from a 256 entry table that is built at compile time.
+ */
+enum SinCharClass : uint8_t
+{
+    SIN_CHAR_WHITESPACE = 1 << 0,
+    // terminates a `.name` key: whitespace or ':'
+    SIN_CHAR_NAME_END = 1 << 1,
+    // terminates the value of a typed number: whitespace, ':' or '}'
+    SIN_CHAR_NUMBER_END = 1 << 2,
+    // terminates an unquoted `[index]` key
+    SIN_CHAR_INDEX_END = 1 << 3,
+    // first character of an untyped number
+    SIN_CHAR_NUMBER_START = 1 << 4,
+    // where skipping over a container has to look closer: brackets, quotes and names
+    SIN_CHAR_STRUCTURE = 1 << 5,
+};
+
+using SinCharTable = std::array<uint8_t, 256>;
+
+constexpr SinCharTable makeSinCharClasses()
+{
+    SinCharTable table{};
+
+    for (unsigned char ch : {' ', '\t', '\n', '\r'})
+    {
+        table[ch] |= SIN_CHAR_WHITESPACE | SIN_CHAR_NAME_END | SIN_CHAR_NUMBER_END;
+    }
+    table[':'] |= SIN_CHAR_NAME_END | SIN_CHAR_NUMBER_END;
+    table['}'] |= SIN_CHAR_NUMBER_END;
+    table[']'] |= SIN_CHAR_INDEX_END;
+    for (unsigned char ch : {'{', '}', '[', ']', '"', '`', '.'})
+    {
+        table[ch] |= SIN_CHAR_STRUCTURE;
+    }
+    table['+'] |= SIN_CHAR_NUMBER_START;
+    table['-'] |= SIN_CHAR_NUMBER_START;
+    for (unsigned char ch = '0'; ch <= '9'; ch++)
+    {
+        table[ch] |= SIN_CHAR_NUMBER_START;
+    }
+
+    return table;
+}
+
+inline constexpr SinCharTable sinCharClasses = makeSinCharClasses();
+
+constexpr bool sinCharIs(char ch, uint8_t classes)
+{
+    return (sinCharClasses[static_cast<unsigned char>(ch)] & classes) != 0;
+}
+
+/**
+ * Escape tables map the character after a backslash to the decoded
+ * character, 0 means the sequence is kept as is
+ */
+using SinEscapeTable = std::array<char, 256>;
+
+constexpr SinEscapeTable makeSinQuoteEscapes()
+{
+    SinEscapeTable table{};
+    table['n'] = '\n';
+    table['r'] = '\r';
+    table['t'] = '\t';
+    table['"'] = '"';
+    table['\\'] = '\\';
+    return table;
+}
+
+constexpr SinEscapeTable makeSinBacktickEscapes()
+{
+    SinEscapeTable table{};
+    table['`'] = '`';
+    table['\\'] = '\\';
+    return table;
+}
+
+inline constexpr SinEscapeTable sinQuoteEscapes = makeSinQuoteEscapes();
+inline constexpr SinEscapeTable sinBacktickEscapes = makeSinBacktickEscapes();
+
+/**
+ * Bulk scanning kernels for the long runs in a document: indentation and
+ * string bodies. Both add the number of '\n' they step over to *newlines.
+ */
+struct SinScanKernels
+{
+    const char *name;
+
+    // length of the whitespace run at the start of data
+    size_t (*skipWhitespace)(const char *data, size_t size, size_t *newlines);
+
+    // offset of the first `quote` or backslash in data, size if there is none
+    size_t (*findStringStop)(const char *data, size_t size, char quote, size_t *newlines);
+};
+
+enum class SinScanLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/**
+ * Kernels for the given instruction set, nullptr if it is not available
+ * on this CPU or was not compiled in
+ */
+const SinScanKernels *sinScanKernelsFor(SinScanLevel level);
+
+/**
+ * The fastest kernels supported by the running CPU, selected on first use
+ */
+const SinScanKernels &sinScanKernels();
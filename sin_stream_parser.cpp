@@ -0,0 +1,231 @@
+#include "sin_stream_parser.h"
+#include "sin_parser_impl.h"
+#include "sin_sax.h"
+
+#include <stdexcept>
+#include <vector>
+
+SinStreamParser::SinStreamParser(std::pmr::memory_resource *resource) : resource(resource)
+{
+}
+
+void SinStreamParser::feed(const char *data, size_t size)
+{
+    if (state == State::Done)
+    {
+        return;
+    }
+
+    pending.append(data, size);
+
+    if (state == State::Whole || state == State::Tail || pending.size() < retry_size)
+    {
+        return;
+    }
+    retry_size = 0;
+
+    if (state == State::Start)
+    {
+        parse_start();
+    }
+    if (state == State::Root)
+    {
+        parse_entries();
+    }
+}
+
+void SinStreamParser::parse_start()
+{
+    SinParser parser(pending, resource, line_number);
+    int ch = parser.read_value_start();
+
+    if (!parser.error.empty())
+    {
+        // an error at the end of the input may only mean the rest hasn't arrived
+        if (parser.eof())
+        {
+            retry_size = 2 * pending.size();
+        }
+        else
+        {
+            state = State::Whole;
+        }
+        return;
+    }
+
+    if (ch != '{' && ch != '[')
+    {
+        state = State::Whole;
+        return;
+    }
+
+    parser.get_char();
+    value = ch == '{' ? Sin::Object(resource) : Sin::Array(resource);
+    pending.erase(0, parser.pos);
+    line_number = parser.line_number;
+    state = State::Root;
+}
+
+size_t SinStreamParser::buffered() const
+{
+    return pending.size();
+}
+
+/**
+ * Adds an entry to the innermost open container
+ */
+static void addEntry(Sin &container, const std::string &key, int32_t index, Sin value)
+{
+    if (container.typeId() == SinType::Object)
+    {
+        SinTreeBuilder::addMember(container, key, std::move(value));
+    }
+    else
+    {
+        SinTreeBuilder::addElement(container, size_t(index), std::move(value));
+    }
+}
+
+void SinStreamParser::close_nested()
+{
+    Nested closed = std::move(nested.back());
+    nested.pop_back();
+    if (closed.container.typeId() == SinType::Array)
+    {
+        SinTreeBuilder::packArray(closed.container);
+    }
+    addEntry(nested.empty() ? value : nested.back().container, closed.key, closed.index, std::move(closed.container));
+}
+
+void SinStreamParser::parse_entries()
+{
+    SinParser parser(pending, resource, line_number);
+    size_t committed = 0;
+
+    while (true)
+    {
+        const bool object = (nested.empty() ? value : nested.back().container).typeId() == SinType::Object;
+        std::string name;
+        int32_t index = 0;
+        Sin entry_value;
+        int opened = 0;
+
+        auto entry = object ? parser.read_object_key(name) : parser.read_array_index(index);
+        if (entry == SinParser::Entry::Value && parser.error.empty())
+        {
+            // containers are opened here, scalars are read from their ':' on
+            size_t start = parser.pos;
+            size_t start_line = parser.line_number;
+            int ch = parser.read_value_start();
+            if (ch == '{' || ch == '[')
+            {
+                parser.get_char();
+                opened = ch;
+            }
+            else if (parser.error.empty())
+            {
+                parser.pos = start;
+                parser.line_number = start_line;
+                entry_value = parser.read_sin_value();
+            }
+        }
+
+        // a value that ends the input may be a cut off number or name
+        if (!parser.error.empty() || (entry == SinParser::Entry::Value && !opened && parser.eof()))
+        {
+            if (parser.eof())
+            {
+                retry_size = 2 * (pending.size() - committed);
+            }
+            else
+            {
+                state = State::Tail;
+            }
+            break;
+        }
+
+        committed = parser.pos;
+        line_number = parser.line_number;
+
+        if (opened)
+        {
+            nested.push_back({opened == '{' ? Sin::Object(resource) : Sin::Array(resource), std::move(name), index});
+        }
+        else if (entry == SinParser::Entry::Value)
+        {
+            addEntry(nested.empty() ? value : nested.back().container, name, index, std::move(entry_value));
+        }
+        else if (!nested.empty())
+        {
+            close_nested();
+        }
+        else
+        {
+            if (!object)
+            {
+                SinTreeBuilder::packArray(value);
+            }
+            state = State::Done;
+            break;
+        }
+    }
+
+    if (state == State::Done)
+    {
+        pending = {};
+    }
+    else
+    {
+        pending.erase(0, committed);
+    }
+}
+
+void SinStreamParser::finish()
+{
+    SinParser parser(pending, resource, line_number);
+
+    switch (state)
+    {
+    case State::Start:
+    case State::Whole:
+        value = parser.read_sin_value();
+        error = parser.error;
+        break;
+    case State::Root:
+    case State::Tail:
+        // the innermost first, as the recursion of a whole parse would
+        while (!nested.empty())
+        {
+            nested.back().container = parser.read_container(std::move(nested.back().container));
+            close_nested();
+        }
+        value = parser.read_container(std::move(value));
+        error = parser.error;
+        break;
+    case State::Done:
+        break;
+    }
+
+    state = State::Done;
+    pending = {};
+}
+
+Sin parseSinStream(std::istream &stream, std::pmr::memory_resource *resource)
+{
+    SinStreamParser parser(resource);
+    std::vector<char> buffer(64 * 1024);
+
+    while (stream)
+    {
+        stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        parser.feed(buffer.data(), static_cast<size_t>(stream.gcount()));
+    }
+    parser.finish();
+
+    if (parser.error != "")
+    {
+        throw std::invalid_argument("Can't parse configuration: " + parser.error);
+    }
+
+    return parser.value;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "sin.h"
+
+/**
+ * Push parser for documents that arrive in pieces, e.g. from a pipe or
+ * a decompression stream.
+ *
+ * Chunks may split the input anywhere, including inside strings, escapes
+ * and numbers. Objects and arrays at any depth are opened as soon as
+ * their bracket arrives and stay open between chunks, their scalar
+ * members are parsed as soon as they are complete and their text is
+ * dropped. Parsing overlaps with reading, and only the unfinished scalar
+ * or key is kept and parsed again when more input arrives, however large
+ * the containers around it are.
+ *
+ * After finish(), value and error are the same as SinParser would give
+ * for the whole input.
+ */
+class SinStreamParser
+{
+public:
+    explicit SinStreamParser(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    void feed(const char *data, size_t size);
+
+    /**
+     * Input kept until its entry is complete
+     */
+    size_t buffered() const;
+
+    /**
+     * Parses the rest of the input, value and error are final afterwards
+     */
+    void finish();
+
+    Sin value;
+    std::string error;
+
+private:
+    enum class State
+    {
+        // the root value hasn't started yet
+        Start,
+        // reading the members or elements of the open containers
+        Root,
+        // an entry of an open container failed, finish() parses the rest
+        Tail,
+        // the root is a scalar or failed to start, finish() parses all of it
+        Whole,
+        // the root container is closed, further input is ignored like SinParser does
+        Done,
+    };
+
+    /**
+     * A container inside the root that is still open, and its key or
+     * index in the one it is in
+     */
+    struct Nested
+    {
+        Sin container;
+        std::string key;
+        int32_t index = 0;
+    };
+
+    std::pmr::memory_resource *resource;
+    State state = State::Start;
+
+    /**
+     * Open containers inside value, innermost last
+     */
+    std::vector<Nested> nested;
+
+    /**
+     * Unparsed input starting at the first incomplete entry
+     */
+    std::string pending;
+    size_t line_number = 0;
+
+    /**
+     * An incomplete entry is only tried again once this much input is
+     * pending, so a large entry is not reparsed for every small chunk
+     */
+    size_t retry_size = 0;
+
+    void parse_start();
+    void parse_entries();
+    void close_nested();
+};
+
+/**
+ * Parses the stream in chunks as it is read, throws std::invalid_argument
+ * like parseSin
+ */
+Sin parseSinStream(std::istream &stream, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
@@ -1 +1,24 @@
 #include "sin_value.h"
+#include "sin.h"
+
+String::String(std::string_view v, std::pmr::memory_resource *resource) : SinValue{}, value(v, resource)
+{
+}
+
+TArray::TArray(std::pmr::memory_resource *resource) : SinValue{}, value(resource)
+{
+}
+
+TArray::~TArray() = default;
+
+TPackedArray::TPackedArray(SinType element) : SinValue{}, element(element)
+{
+}
+
+TPackedArray::~TPackedArray() = default;
+
+TObject::TObject(std::pmr::memory_resource *resource) : SinValue{}, value(resource)
+{
+}
+
+TObject::~TObject() = default;
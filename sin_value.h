@@ -1,18 +1,210 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "sin_object.h"
+
 class Sin;
 
-#define SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(SIN_TYPE, STANDARD_TYPE) \
-    struct SIN_TYPE : SinValue                                      \
-    {                                                               \
-        STANDARD_TYPE value;                                        \
-        SIN_TYPE(STANDARD_TYPE v) : SinValue{}, value{v} {}         \
+/**
+ * Compact discriminator of the value held by a Sin
+ */
+enum class SinType : uint8_t
+{
+    Undefined,
+    Uint8,
+    Int8,
+    Uint16,
+    Int16,
+    Uint32,
+    Int32,
+    Uint64,
+    Int64,
+    Float,
+    Double,
+    String,
+    Bool,
+    Array,
+    Object,
+};
+
+/**
+ * Name of the type as it is written in SIN documents, e.g. "Int32"
+ */
+constexpr const char *sinTypeName(SinType type)
+{
+    // indexed by SinType
+    constexpr const char *names[] = {"Undefined", "Uint8", "Int8", "Uint16", "Int16", "Uint32", "Int32", "Uint64",
+                                     "Int64", "Float", "Double", "String", "Bool", "Array", "Object"};
+    return size_t(type) < std::size(names) ? names[size_t(type)] : "Undefined";
+}
+
+/**
+ * The number type a C++ type is stored as, Undefined for other types
+ */
+template <class T>
+constexpr SinType sinNumberType()
+{
+    if constexpr (std::is_same_v<T, uint8_t>)
+        return SinType::Uint8;
+    else if constexpr (std::is_same_v<T, int8_t>)
+        return SinType::Int8;
+    else if constexpr (std::is_same_v<T, uint16_t>)
+        return SinType::Uint16;
+    else if constexpr (std::is_same_v<T, int16_t>)
+        return SinType::Int16;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+        return SinType::Uint32;
+    else if constexpr (std::is_same_v<T, int32_t>)
+        return SinType::Int32;
+    else if constexpr (std::is_same_v<T, uint64_t>)
+        return SinType::Uint64;
+    else if constexpr (std::is_same_v<T, int64_t>)
+        return SinType::Int64;
+    else if constexpr (std::is_same_v<T, float>)
+        return SinType::Float;
+    else if constexpr (std::is_same_v<T, double>)
+        return SinType::Double;
+    else
+        return SinType::Undefined;
+}
+
+/**
+ * Whether every value of number type From is exactly a value of To, e.g.
+ * Int8 in int64_t, Uint16 in int32_t or Int32 in double
+ */
+template <class From, class To>
+constexpr bool sinWidens()
+{
+    using FromLimits = std::numeric_limits<From>;
+    using ToLimits = std::numeric_limits<To>;
+    if constexpr (std::is_same_v<From, bool> || std::is_same_v<To, bool>)
+        return false;
+    else if constexpr (std::is_floating_point_v<To>)
+        return FromLimits::digits <= ToLimits::digits && FromLimits::max_exponent <= ToLimits::max_exponent;
+    else if constexpr (std::is_floating_point_v<From>)
+        return false;
+    else if constexpr (FromLimits::is_signed && !ToLimits::is_signed)
+        return false;
+    else
+        return FromLimits::digits <= ToLimits::digits;
+}
+
+/**
+ * Scalars are stored inline in Sin, only strings, arrays and objects
+ * are kept in heap allocated SinValue nodes
+ */
+union SinScalar
+{
+    uint8_t Uint8;
+    int8_t Int8;
+    uint16_t Uint16;
+    int16_t Int16;
+    uint32_t Uint32;
+    int32_t Int32;
+    uint64_t Uint64;
+    int64_t Int64;
+    float Float;
+    double Double;
+    bool Bool;
+};
+
+/**
+ * The member of SinScalar that holds a T, T is a number type or bool
+ */
+template <class T>
+constexpr T SinScalar::*sinScalarMember()
+{
+    if constexpr (std::is_same_v<T, uint8_t>)
+        return &SinScalar::Uint8;
+    else if constexpr (std::is_same_v<T, int8_t>)
+        return &SinScalar::Int8;
+    else if constexpr (std::is_same_v<T, uint16_t>)
+        return &SinScalar::Uint16;
+    else if constexpr (std::is_same_v<T, int16_t>)
+        return &SinScalar::Int16;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+        return &SinScalar::Uint32;
+    else if constexpr (std::is_same_v<T, int32_t>)
+        return &SinScalar::Int32;
+    else if constexpr (std::is_same_v<T, uint64_t>)
+        return &SinScalar::Uint64;
+    else if constexpr (std::is_same_v<T, int64_t>)
+        return &SinScalar::Int64;
+    else if constexpr (std::is_same_v<T, float>)
+        return &SinScalar::Float;
+    else if constexpr (std::is_same_v<T, double>)
+        return &SinScalar::Double;
+    else
+    {
+        static_assert(std::is_same_v<T, bool>, "SinScalar holds numbers and bools");
+        return &SinScalar::Bool;
     }
+}
+
+/**
+ * Calls f with a value of the C++ type a number type is stored as, e.g.
+ * int8_t{} for Int8, and does nothing for other types. This is the one
+ * switch over the number types: serialization, conversions and packed
+ * arrays all dispatch through it, each case is compiled for its own type.
+ */
+template <class F>
+constexpr void withSinNumberType(SinType type, F &&f)
+{
+    switch (type)
+    {
+    case SinType::Uint8:
+        return f(uint8_t{});
+    case SinType::Int8:
+        return f(int8_t{});
+    case SinType::Uint16:
+        return f(uint16_t{});
+    case SinType::Int16:
+        return f(int16_t{});
+    case SinType::Uint32:
+        return f(uint32_t{});
+    case SinType::Int32:
+        return f(int32_t{});
+    case SinType::Uint64:
+        return f(uint64_t{});
+    case SinType::Int64:
+        return f(int64_t{});
+    case SinType::Float:
+        return f(float{});
+    case SinType::Double:
+        return f(double{});
+    default:
+        return;
+    }
+}
+
+/**
+ * Calls f with the number or bool a scalar of the given type holds, as its
+ * own C++ type. Returns false without calling f for other types.
+ */
+template <class F>
+constexpr bool visitSinScalar(SinType type, const SinScalar &scalar, F &&f)
+{
+    if (type == SinType::Bool)
+    {
+        f(scalar.Bool);
+        return true;
+    }
+    bool number = false;
+    withSinNumberType(type, [&](auto zero)
+                      {
+                          f(scalar.*sinScalarMember<decltype(zero)>());
+                          number = true; });
+    return number;
+}
 
 struct SinValue
 {
@@ -20,29 +212,47 @@ struct SinValue
     virtual ~SinValue(){};
 };
 
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Uint8, uint8_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Int8, int8_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Uint16, uint16_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Int16, int16_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Uint32, uint32_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Int32, int32_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Uint64, uint64_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Int64, int64_t);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Float, float);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Double, double);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Long, long);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Ulong, unsigned long);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(String, std::string);
-SIN_DEFINE_STANDARD_TYPE_SIN_VALUE(Bool, bool);
+/**
+ * Containers take their memory from a std::pmr resource, so a whole parsed
+ * document can live in one SinArena. Objects are a SinObject, see sin_object.h.
+ */
+using SinArray = std::pmr::vector<Sin>;
+
+struct String : SinValue
+{
+    std::pmr::string value;
+    String(std::string_view v, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+};
 
 struct TArray : SinValue
 {
-    std::vector<Sin> value;
+    SinArray value;
+    TArray(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    ~TArray();
+};
+
+/**
+ * An Array whose elements are all numbers of one type, stored contiguously
+ */
+struct TPackedArray : SinValue
+{
+    const SinType element;
+    TPackedArray(SinType element);
+    ~TPackedArray();
+};
+
+template <class T>
+struct TPacked final : TPackedArray
+{
+    std::pmr::vector<T> value;
+    TPacked(std::pmr::memory_resource *resource) : TPackedArray(sinNumberType<T>()), value(resource) {}
 };
 
 struct TObject : SinValue
 {
-    std::map<std::string, Sin> value;
+    SinObject value;
+    TObject(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    ~TObject();
 };
 
 struct Undefined : SinValue
@@ -0,0 +1,67 @@
+#include "sin_writer.h"
+
+#include <charconv>
+
+static const char *escapeFor(char ch)
+{
+    switch (ch)
+    {
+    case '\t':
+        return "\\t";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    default:
+        return nullptr;
+    }
+}
+
+void SinWriter::writeEscaped(std::string_view text)
+{
+    // copy runs of plain characters in one append
+    size_t start = 0;
+
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        const char *escape = escapeFor(text[i]);
+        if (escape)
+        {
+            _out->append(text.data() + start, i - start);
+            _out->append(escape, 2);
+            start = i + 1;
+        }
+    }
+
+    write(text.substr(start));
+}
+
+void SinWriter::writeKey(int level, std::string_view key)
+{
+    indent(level);
+    if (key.find(' ') == std::string_view::npos)
+    {
+        put('.');
+        write(key);
+    }
+    else
+    {
+        write("[\"");
+        writeEscaped(key);
+        write("\"]");
+    }
+}
+
+void SinWriter::writeIndex(int level, size_t index)
+{
+    char buffer[24];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), index).ptr;
+    indent(level);
+    put('[');
+    write(std::string_view(buffer, end - buffer));
+    put(']');
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * Layout of the text form. Both layouts are read back by the parser.
+ */
+struct SinFormat
+{
+    // indentation per nesting level, indentChar must be whitespace
+    int indent = 2;
+    char indentChar = ' ';
+
+    // one line, no indentation and only the separators the parser needs
+    bool compact = false;
+};
+
+/**
+ * Output sink for Sin::serialize.
+ *
+ * Writes either append straight to a caller owned std::string, or go into
+ * an internal buffer that is handed to an std::ostream in large chunks.
+ * The buffer is flushed by flush() and by the destructor.
+ */
+class SinWriter
+{
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+    std::string _buffer;
+    std::string *_out;
+    std::ostream *_stream = nullptr;
+    SinFormat _format;
+
+public:
+    explicit SinWriter(std::string &out, const SinFormat &format = {}) : _out{&out}, _format{format} {}
+
+    explicit SinWriter(std::ostream &stream, const SinFormat &format = {}) : _out{&_buffer}, _stream{&stream}, _format{format}
+    {
+        _buffer.reserve(FLUSH_SIZE + 4096);
+    }
+
+    SinWriter(const SinWriter &) = delete;
+    SinWriter &operator=(const SinWriter &) = delete;
+
+    ~SinWriter()
+    {
+        flush();
+    }
+
+    void write(std::string_view text)
+    {
+        _out->append(text);
+        if (_stream && _buffer.size() >= FLUSH_SIZE)
+        {
+            flush();
+        }
+    }
+
+    void put(char ch)
+    {
+        _out->push_back(ch);
+    }
+
+    void fill(size_t count, char ch)
+    {
+        _out->append(count, ch);
+    }
+
+    const SinFormat &format() const
+    {
+        return _format;
+    }
+
+    /**
+     * Indentation for the nesting level, nothing in compact mode
+     */
+    void indent(int level)
+    {
+        if (!_format.compact)
+        {
+            fill(size_t(level) * _format.indent, _format.indentChar);
+        }
+    }
+
+    void newline()
+    {
+        if (!_format.compact)
+        {
+            put('\n');
+        }
+    }
+
+    /**
+     * Writes the text with \t, \n, \r, " and \ escaped
+     */
+    void writeEscaped(std::string_view text);
+
+    /**
+     * The separator between a key or index and its value
+     */
+    void writeColon()
+    {
+        write(_format.compact ? ":" : ": ");
+    }
+
+    /**
+     * An object member's key on its own line: .name, or ["name"] for keys with spaces
+     */
+    void writeKey(int level, std::string_view key);
+
+    /**
+     * An array element's [index] on its own line
+     */
+    void writeIndex(int level, size_t index);
+
+    /**
+     * Numbers and bools are bare tokens that only end at whitespace,
+     * compact output has to separate them from the next key or bracket
+     */
+    void endToken()
+    {
+        if (_format.compact)
+        {
+            put(' ');
+        }
+    }
+
+    void flush()
+    {
+        if (_stream && !_buffer.empty())
+        {
+            _stream->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.clear();
+        }
+    }
+};
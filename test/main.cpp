@@ -1,6 +1,15 @@
 #define CATCH_CONFIG_MAIN
 #include "catch2/catch_all.hpp"
 #include "sin.h"
+#include "sin_parser.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 TEST_CASE("Check setters and getters")
 {
@@ -98,4 +107,367 @@ TEST_CASE("Check Parser and stringification matching")
   a["d"]["df"] = {double{6}, 5.5, 10, g};
 
   REQUIRE(Sin::parse(a.toString()).toString() == a.toString());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Check type ids")
+{
+  Sin a;
+  REQUIRE(a.typeId() == SinType::Object);
+
+  a = Sin::Array();
+  REQUIRE(a.typeId() == SinType::Array);
+
+  a = uint16_t{7};
+  REQUIRE(a.typeId() == SinType::Uint16);
+  REQUIRE(a.type() == "Uint16");
+
+  REQUIRE_THROWS(a.asInt32());
+  REQUIRE_THROWS(a.asArray());
+}
+
+TEST_CASE("Check copies and moves of inline and heap values")
+{
+  Sin a = 5.5;
+  Sin b = a;
+  REQUIRE(b.asDouble() == 5.5);
+
+  b = "text";
+  REQUIRE(a.asDouble() == 5.5);
+  REQUIRE(b.asString() == "text");
+
+  Sin c = std::move(b);
+  REQUIRE(c.asString() == "text");
+
+  a = {1, "two", 3.0};
+  a = a[1];
+  REQUIRE(a.asString() == "two");
+
+  a = {1, 2};
+  a = std::move(a[0]);
+  REQUIRE(a.asInt32() == 1);
+}
+
+TEST_CASE("Check copies don't see changes made through each other")
+{
+  Sin base = Sin::parse(": {\n  .server: {\n    .port: Uint16 80\n    .hosts: [\n      [0]: \"a\"\n      [1]: \"b\"\n    ]\n  }\n  .limits: {\n    .max: 5\n  }\n  .name: \"svc\"\n}");
+  const std::string text = base.toString();
+
+  Sin patched = base;
+  patched["server"]["port"] = uint16_t(8080);
+  patched["server"]["hosts"][2] = "c";
+  patched["verbose"] = true;
+  REQUIRE(base.toString() == text);
+  REQUIRE(patched["server"]["port"].asUint16() == 8080);
+  REQUIRE(patched["server"]["hosts"].asArray().size() == 3);
+
+  // only the changed path was copied, the rest is shared
+  const Sin &constBase = base;
+  const Sin &constPatched = patched;
+  auto member = [](const Sin &sin, const char *key) -> const Sin &
+  { return sin.asObject().find(key)->second; };
+  REQUIRE(&member(constBase, "limits").asObject() == &member(constPatched, "limits").asObject());
+  REQUIRE(member(constBase, "name").asStringView().data() == member(constPatched, "name").asStringView().data());
+  REQUIRE(&member(constBase, "server").asObject() != &member(constPatched, "server").asObject());
+
+  // the original can be changed too without reaching the copy
+  base["server"]["hosts"][0] = "z";
+  REQUIRE(patched["server"]["hosts"][0].asString() == "a");
+  REQUIRE(base["server"]["hosts"][1].asString() == "b");
+
+  // copies held by other containers
+  Sin list = {base, base};
+  list[0]["limits"]["max"] = 6;
+  REQUIRE(list[1]["limits"]["max"].asInt32() == 5);
+  REQUIRE(base["limits"]["max"].asInt32() == 5);
+
+  Sin third = patched;
+  third.asObject().erase("verbose");
+  REQUIRE(patched.asObject().contains("verbose"));
+  REQUIRE_FALSE(third.asObject().contains("verbose"));
+}
+
+namespace
+{
+  /**
+   * Counts what is allocated from it, from any thread
+   */
+  struct CountingResource : std::pmr::memory_resource
+  {
+    std::atomic<size_t> allocations{0};
+
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+      allocations++;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+  };
+}
+
+TEST_CASE("Check copies of an arena document are patched outside the arena")
+{
+  std::string text = ": {\n  .limits: {\n    .max: 5\n  }\n  .routes: [\n";
+  for (int i = 0; i < 100; i++)
+  {
+    text += "    [" + std::to_string(i) + "]: {\n      .port: " + std::to_string(i) + "\n    }\n";
+  }
+  text += "  ]\n}\n";
+
+  CountingResource arena;
+  const Sin base = parseSin(text, &arena);
+  const std::string expected = base.toString();
+  const size_t parsed = arena.allocations;
+
+  // per-request overrides on copies of one shared base, from several threads
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([&base, t]
+                         {
+                           for (int i = 0; i < 50; i++)
+                           {
+                             Sin patched = base;
+                             patched["limits"]["max"] = t * 100 + i;
+                             patched["routes"][i]["port"] = -i;
+                             patched["routes"].push_back(t);
+                             if (patched["limits"]["max"].asInt32() != t * 100 + i || patched["routes"][i]["port"].asInt32() != -i)
+                             {
+                               throw std::runtime_error("lost a patch");
+                             }
+                           } });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(arena.allocations == parsed);
+  REQUIRE(base.toString() == expected);
+
+  // the same with a real arena, which is not thread-safe at all
+  SinArena real;
+  const Sin arenaBase = Sin::parse(text, real);
+  std::vector<std::thread> patchers;
+  for (int t = 0; t < 4; t++)
+  {
+    patchers.emplace_back([&arenaBase]
+                          {
+                            for (int i = 0; i < 50; i++)
+                            {
+                              Sin patched = arenaBase;
+                              patched["routes"][i]["port"] = i + 1;
+                            } });
+  }
+  for (auto &thread : patchers)
+  {
+    thread.join();
+  }
+  REQUIRE(arenaBase.toString() == expected);
+}
+
+TEST_CASE("Check emplace, push_back and setters")
+{
+  static_assert(std::is_nothrow_move_constructible_v<Sin>);
+  static_assert(std::is_nothrow_move_assignable_v<Sin>);
+
+  Sin config;
+  REQUIRE(config.emplace("port", uint16_t(80)).asUint16() == 80);
+  // like try_emplace, an existing member is kept
+  REQUIRE(config.emplace("port", uint16_t(81)).asUint16() == 80);
+
+  Sin hosts;
+  hosts.push_back("a");
+  Sin host = std::string("a host name that does not fit in place");
+  const char *characters = host.asStringView().data();
+  Sin &added = hosts.push_back(std::move(host));
+  REQUIRE(added.asStringView().data() == characters);
+  REQUIRE(hosts.asArray().size() == 2);
+  config.emplace("hosts", std::move(hosts));
+  REQUIRE(config["hosts"][1].asString() == "a host name that does not fit in place");
+
+  const std::string name = "svc";
+  config["name"] = name;
+  config["name"] = "other";
+  (config["retries"] = 3) = 4;
+  REQUIRE(config["name"].asString() == "other");
+  REQUIRE(config["retries"].asInt32() == 4);
+
+  config["limits"] = {1, 2};
+  REQUIRE(config["limits"].asArray().size() == 2);
+  config["limits"] = {};
+  REQUIRE(config["limits"].typeId() == SinType::Object);
+  REQUIRE(config["limits"].asObject().empty());
+}
+
+TEST_CASE("Check typed getters")
+{
+  Sin small = int8_t(-5);
+  REQUIRE(small.get<int8_t>() == -5);
+  REQUIRE(small.get<int64_t>() == -5);
+  REQUIRE(small.get<double>() == -5.0);
+  REQUIRE(small.is<int16_t>());
+  REQUIRE_FALSE(small.is<uint64_t>());
+  REQUIRE_FALSE(small.try_get<uint8_t>());
+  REQUIRE_THROWS(small.get<uint32_t>());
+
+  Sin port = uint16_t(8080);
+  REQUIRE(port.get<int32_t>() == 8080);
+  REQUIRE(port.get<uint64_t>() == 8080);
+  REQUIRE(port.get<float>() == 8080.0f);
+  REQUIRE_FALSE(port.is<int16_t>());
+  REQUIRE_FALSE(port.is<uint8_t>());
+
+  // only conversions that keep every value exactly
+  Sin big = int64_t(1) << 40;
+  REQUIRE(big.get<int64_t>() == int64_t(1) << 40);
+  REQUIRE_FALSE(big.is<int32_t>());
+  REQUIRE_FALSE(big.is<double>());
+  REQUIRE(Sin(int32_t(7)).get<double>() == 7.0);
+  REQUIRE_FALSE(Sin(int32_t(7)).is<float>());
+  REQUIRE(Sin(1.5f).get<double>() == 1.5);
+  REQUIRE_FALSE(Sin(1.5).is<float>());
+  REQUIRE_FALSE(Sin(1.5).is<int64_t>());
+
+  Sin name = "svc";
+  REQUIRE(name.get<std::string>() == "svc");
+  REQUIRE(name.get<std::string_view>() == "svc");
+  REQUIRE_FALSE(name.is<int32_t>());
+  REQUIRE_FALSE(Sin(1).is<std::string>());
+  REQUIRE(Sin(true).get<bool>());
+  REQUIRE_FALSE(Sin(1).is<bool>());
+  REQUIRE_FALSE(Sin(true).is<int32_t>());
+  REQUIRE_THROWS(Sin::Array().get<bool>());
+  REQUIRE(Sin::Object().try_get<int32_t>() == std::nullopt);
+}
+
+TEST_CASE("Check serialization into a buffer and a stream")
+{
+  Sin a = Sin::Object();
+  a["third"] = 0.1;
+  a["whole"] = 6.0;
+  a["big"] = 1e300;
+  a["negative zero"] = -0.0;
+  a["inf"] = std::numeric_limits<double>::infinity();
+  a["float"] = float{0.1f};
+  a["small"] = int8_t{-128};
+  a["text"] = "tab\there \"quoted\"";
+  a["list"] = {1, uint64_t{18446744073709551615ull}, true};
+
+  std::string text = a.toString();
+  REQUIRE(text.find(".third: 0.1\n") != std::string::npos);
+  REQUIRE(text.find(".whole: 6.0\n") != std::string::npos);
+
+  Sin b = Sin::parse(text);
+  REQUIRE(b["third"].asDouble() == 0.1);
+  REQUIRE(b["whole"].asDouble() == 6.0);
+  REQUIRE(b["big"].asDouble() == 1e300);
+  REQUIRE(std::signbit(b["negative zero"].asDouble()));
+  REQUIRE(b["inf"].asDouble() == std::numeric_limits<double>::infinity());
+  REQUIRE(b["float"].asFloat() == 0.1f);
+  REQUIRE(b["small"].asInt8() == -128);
+  REQUIRE(b["text"].asString() == "tab\there \"quoted\"");
+  REQUIRE(b["list"][1].asUint64() == 18446744073709551615ull);
+  REQUIRE(b.toString() == text);
+
+  std::string appended = "prefix";
+  a.toString(appended);
+  REQUIRE(appended == "prefix" + text);
+
+  std::ostringstream stream;
+  {
+    SinWriter writer(stream);
+    a.serialize(writer);
+  }
+  REQUIRE(stream.str() == text);
+}
+
+TEST_CASE("Check compact and indented output")
+{
+  Sin a = Sin::Object();
+  a["id"] = 7;
+  a["port"] = uint16_t{8080};
+  a["on"] = true;
+  a["name with spaces"] = "x";
+  a["list"] = {1, 2.5, uint8_t{3}, "s", Sin::Object(), Sin::Array()};
+  a["nested"]["deep"]["value"] = -1;
+  a["last"] = int64_t{-5};
+
+  const std::string pretty = a.toString();
+
+  SinFormat compact;
+  compact.compact = true;
+  std::string text = a.toString(compact);
+  REQUIRE(text.find('\n') == std::string::npos);
+  REQUIRE(text.size() < pretty.size());
+  REQUIRE(text.substr(0, 12) == ":{.id:7 .las");
+  REQUIRE(Sin::parse(text).toString() == pretty);
+
+  REQUIRE(Sin::parse(": 5").toString(compact) == ":5");
+  REQUIRE(Sin::parse(": Uint8 5").toString(compact) == ":Uint8 5");
+
+  SinFormat tabs;
+  tabs.indent = 1;
+  tabs.indentChar = '\t';
+  text = a.toString(tabs);
+  REQUIRE(text.find("\n\t.id: 7\n") != std::string::npos);
+  REQUIRE(Sin::parse(text).toString() == pretty);
+
+  SinFormat wide;
+  wide.indent = 4;
+  text = a.toString(wide);
+  REQUIRE(text.find("\n    .port: Uint16\n    8080\n") != std::string::npos);
+  REQUIRE(Sin::parse(text).toString() == pretty);
+}
+
+TEST_CASE("Check parallel serialization matches toString")
+{
+  Sin array = Sin::Array();
+  for (int i = 0; i < 1000; i++)
+  {
+    Sin record = Sin::Object();
+    record["id"] = i;
+    record["port"] = uint16_t(8000 + i);
+    record["name with spaces"] = "n" + std::to_string(i);
+    record["list"] = {i * 0.5, true};
+    array.asArray().push_back(i % 10 == 0 ? Sin(int64_t{i}) : record);
+  }
+  Sin object = Sin::Object();
+  for (int i = 0; i < 1000; i++)
+  {
+    object["key" + std::to_string(i)] = array[i];
+  }
+
+  SinFormat compact;
+  compact.compact = true;
+  SinFormat tabs;
+  tabs.indent = 1;
+  tabs.indentChar = '\t';
+
+  for (const Sin *root : {&array, &object})
+  {
+    for (const SinFormat &format : {SinFormat{}, compact, tabs})
+    {
+      const std::string expected = root->toString(format);
+      for (unsigned threads : {2u, 3u, 7u, 64u})
+      {
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+          REQUIRE(root->toStringParallel(threads, format) == expected);
+        }
+      }
+    }
+  }
+
+  REQUIRE(Sin::parse(": 5").toStringParallel(4) == ": 5\n");
+  REQUIRE(Sin::Array().toStringParallel(4) == Sin::Array().toString());
+  REQUIRE(Sin({1}).toStringParallel(4) == Sin({1}).toString());
+}
@@ -0,0 +1,139 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_binary.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+static const char *allTypes = ": {\n"
+                              "  .u8: Uint8\n  255\n"
+                              "  .i8: Int8\n  -128\n"
+                              "  .u16: Uint16\n  65535\n"
+                              "  .i16: Int16\n  -32768\n"
+                              "  .u32: Uint32\n  4294967295\n"
+                              "  .i32: -2147483648\n"
+                              "  .u64: Uint64\n  18446744073709551615\n"
+                              "  .i64: Int64\n  -9223372036854775808\n"
+                              "  .f: Float\n  0.1\n"
+                              "  .d: 2.5e-300\n"
+                              "  .b: false\n"
+                              "  .s: \"tab\\tquote\\\"\"\n"
+                              "  [\"with space\"]: \"\"\n"
+                              "  .list: [\n"
+                              "    [0]: 1\n"
+                              "    [1]: {\n"
+                              "      .x: true\n"
+                              "    }\n"
+                              "    [2]: [\n"
+                              "    ]\n"
+                              "  ]\n"
+                              "  .empty: {\n"
+                              "  }\n"
+                              "}\n";
+
+TEST_CASE("SIN binary: round trip")
+{
+    Sin sin = Sin::parse(allTypes);
+    std::string binary = sinToBinary(sin);
+
+    SECTION("Through the tree")
+    {
+        CHECK(SinBinaryView::root(binary).toSin().toString() == sin.toString());
+    }
+
+    SECTION("Text conversion")
+    {
+        CHECK(sinTextToBinary(allTypes) == binary);
+        CHECK(sinBinaryToText(binary) == sin.toString());
+
+        SinFormat compact;
+        compact.compact = true;
+        CHECK(sinBinaryToText(binary, compact) == sin.toString(compact));
+    }
+
+    SECTION("Scalar roots")
+    {
+        CHECK(sinBinaryToText(sinTextToBinary(": Uint16 7")) == Sin::parse(": Uint16 7").toString());
+        CHECK(sinBinaryToText(sinTextToBinary(": \"text\"")) == Sin::parse(": \"text\"").toString());
+    }
+}
+
+TEST_CASE("SIN binary: view")
+{
+    std::string binary = sinTextToBinary(allTypes);
+    SinBinaryView root = SinBinaryView::root(binary);
+
+    REQUIRE(root.typeId() == SinType::Object);
+    CHECK(root.size() == 15);
+
+    CHECK(root["u8"].asUint8() == 255);
+    CHECK(root["i8"].asInt8() == -128);
+    CHECK(root["u16"].asUint16() == 65535);
+    CHECK(root["i16"].asInt16() == -32768);
+    CHECK(root["u32"].asUint32() == 4294967295u);
+    CHECK(root["i32"].asInt32() == INT32_MIN);
+    CHECK(root["u64"].asUint64() == UINT64_MAX);
+    CHECK(root["i64"].asInt64() == INT64_MIN);
+    CHECK(root["f"].asFloat() == 0.1f);
+    CHECK(root["d"].asDouble() == 2.5e-300);
+    CHECK(root["b"].asBool() == false);
+    CHECK(root["s"].asString() == "tab\tquote\"");
+    CHECK(root["with space"].asString() == "");
+
+    CHECK(root["list"].size() == 3);
+    CHECK(root["list"][0].asInt32() == 1);
+    CHECK(root["list"][1]["x"].asBool() == true);
+    CHECK(root["list"][2].size() == 0);
+    CHECK(root["empty"].size() == 0);
+
+    // keys come back sorted
+    for (size_t i = 1; i < root.size(); i++)
+    {
+        CHECK(root.keyAt(i - 1) < root.keyAt(i));
+    }
+
+    CHECK_FALSE(root.find("missing"));
+    CHECK_THROWS_AS(root["missing"], std::out_of_range);
+    CHECK_THROWS_AS(root["list"][3], std::out_of_range);
+    CHECK_THROWS(root["u8"].asInt32());
+    CHECK_THROWS(root["s"].size());
+}
+
+TEST_CASE("SIN binary: malformed data")
+{
+    std::string binary = sinTextToBinary(allTypes);
+
+    CHECK_THROWS_AS(SinBinaryView::root(""), std::invalid_argument);
+    CHECK_THROWS_AS(SinBinaryView::root(": {}"), std::invalid_argument);
+
+    std::string version = binary;
+    version[4] = 2;
+    CHECK_THROWS_AS(SinBinaryView::root(version), std::invalid_argument);
+
+    // the tree reads every byte, so any truncation is detected
+    for (size_t size = 0; size < binary.size(); size++)
+    {
+        std::string_view truncated(binary.data(), size);
+        CHECK_THROWS_AS(SinBinaryView::root(truncated).toSin(), std::invalid_argument);
+    }
+}
+
+TEST_CASE("SIN binary: memory mapped file")
+{
+    const std::string path = "sin_binary_test.sinb";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << sinTextToBinary(allTypes);
+    }
+
+    {
+        SinBinaryFile file(path);
+        CHECK(file.root()["list"][1]["x"].asBool() == true);
+        CHECK(file.root().toSin().toString() == Sin::parse(allTypes).toString());
+    }
+    std::remove(path.c_str());
+
+    CHECK_THROWS_AS(SinBinaryFile("does/not/exist.sinb"), std::system_error);
+}
@@ -0,0 +1,155 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_bind.h"
+#include "sin_parser_impl.h"
+
+#include <string>
+#include <vector>
+
+struct BindLimits
+{
+    int32_t rate = 0;
+    std::vector<int32_t> bursts;
+};
+
+struct BindConfig
+{
+    uint16_t port = 0;
+    std::string host;
+    bool enabled = false;
+    float ratio = 0;
+    int64_t timeout = -1;
+    BindLimits limits;
+    std::vector<BindLimits> tiers;
+    Sin extra;
+};
+
+SIN_BIND(BindLimits, rate, bursts)
+SIN_BIND(BindConfig, port, host, enabled, ratio, timeout, limits, tiers, extra)
+
+static BindConfig sampleConfig()
+{
+    BindConfig config;
+    config.port = 8080;
+    config.host = "a \"quoted\" host";
+    config.enabled = true;
+    config.ratio = 0.25f;
+    config.timeout = int64_t(1) << 40;
+    config.limits = {100, {1, 2, 3}};
+    config.tiers = {{1, {}}, {2, {20}}};
+    config.extra = Sin::Object();
+    config.extra["any"] = {1, "two"};
+    return config;
+}
+
+TEST_CASE("Bind: hand written documents")
+{
+    const char *text = ": {\n"
+                       "  .port: 8080\n"
+                       "  .host: \"localhost\"\n"
+                       "  .unknown: {\n"
+                       "    .deep: [\n"
+                       "      [0]: 1\n"
+                       "    ]\n"
+                       "  }\n"
+                       "  .ratio: 0.5\n"
+                       "  .limits: {\n"
+                       "    .bursts: [\n"
+                       "      [2]: 7\n"
+                       "      [0]: 5\n"
+                       "    ]\n"
+                       "  }\n"
+                       "  .extra: 3\n"
+                       "}\n";
+
+    auto config = decodeSin<BindConfig>(text);
+    CHECK(config.port == 8080);
+    CHECK(config.host == "localhost");
+    CHECK(config.ratio == 0.5f);
+    CHECK(config.limits.bursts == std::vector<int32_t>{5, 0, 7});
+    CHECK(config.extra.asInt32() == 3);
+
+    // members the document doesn't have keep their values
+    CHECK(config.timeout == -1);
+    CHECK(config.limits.rate == 0);
+    CHECK_FALSE(config.enabled);
+}
+
+TEST_CASE("Bind: values that don't fit their members")
+{
+    BindConfig config;
+    CHECK_THROWS_AS(decodeSin(": {\n  .port: 70000\n}\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": {\n  .port: -1\n}\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": {\n  .host: 1\n}\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": {\n  .limits: [\n  ]\n}\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": {\n  .timeout: 1.5\n}\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": 5\n", config), std::invalid_argument);
+    CHECK_THROWS_AS(decodeSin(": {\n  .port: \n", config), std::invalid_argument);
+
+    try
+    {
+        decodeSin(": {\n  .enabled: \"yes\"\n}\n", config);
+        FAIL("no exception");
+    }
+    catch (const std::invalid_argument &error)
+    {
+        CHECK(std::string(error.what()) == "Type assertion. Requested type: Bool, Actual type: String");
+    }
+}
+
+TEST_CASE("Bind: encoded text is what the tree would write")
+{
+    const BindConfig config = sampleConfig();
+
+    SinFormat compact;
+    compact.compact = true;
+    for (const SinFormat &format : {SinFormat{}, compact})
+    {
+        const std::string text = encodeSin(config, format);
+        Sin tree = Sin::parse(text);
+        CHECK(tree["port"].asUint16() == 8080);
+        CHECK(tree["tiers"][1]["bursts"][0].asInt32() == 20);
+
+        auto decoded = decodeSin<BindConfig>(text);
+        CHECK(decoded.port == config.port);
+        CHECK(decoded.host == config.host);
+        CHECK(decoded.enabled == config.enabled);
+        CHECK(decoded.ratio == config.ratio);
+        CHECK(decoded.timeout == config.timeout);
+        CHECK(decoded.limits.rate == 100);
+        CHECK(decoded.limits.bursts == config.limits.bursts);
+        REQUIRE(decoded.tiers.size() == 2);
+        CHECK(decoded.tiers[1].bursts == std::vector<int32_t>{20});
+        CHECK(decoded.extra.toString() == config.extra.toString());
+    }
+
+    // the same entries as the tree, in the order of SIN_BIND
+    BindLimits limits{7, {1, 2}};
+    Sin tree = Sin::Object();
+    tree["rate"] = 7;
+    tree["bursts"] = {1, 2};
+    CHECK(encodeSin(limits) == ": {\n  .rate: 7\n  .bursts: [\n    [0]: 1\n    [1]: 2\n  ]\n}\n");
+    CHECK(Sin::parse(encodeSin(limits)).toString() == tree.toString());
+
+    // undefined Sin members are left out like undefined members of a tree
+    BindConfig holes;
+    holes.extra = Sin::Undefined();
+    CHECK(encodeSin(holes).find(".extra") == std::string::npos);
+    CHECK(decodeSin<BindConfig>(encodeSin(holes)).port == 0);
+    CHECK(encodeSin(std::vector<Sin>{Sin::Undefined(), Sin(1)}) == ": [\n  [1]: 1\n]\n");
+}
+
+TEST_CASE("Bind: a decoder reused for many documents")
+{
+    SinParser parser;
+    SinBindDecoder decoder;
+    for (int i = 0; i < 100; i++)
+    {
+        BindLimits limits;
+        decoder.bind(limits);
+        parser.parse(": {\n  .rate: " + std::to_string(i) + "\n  .bursts: [\n    [0]: 1\n  ]\n}\n", decoder);
+        REQUIRE(decoder.error().empty());
+        CHECK(limits.rate == i);
+        CHECK(limits.bursts.size() == 1);
+    }
+}
@@ -0,0 +1,85 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_lazy.h"
+
+#include <stdexcept>
+#include <string>
+
+static const char *document = ": {\n"
+                              "  .name: \"node\"\n"
+                              "  .port: Uint16\n  8080\n"
+                              "  .limits: [\n"
+                              "    [0]: 1\n"
+                              "    [3]: Int64 4\n"
+                              "  ]\n"
+                              "  [\"with space\"]: true\n"
+                              "  [plain]: 2.5\n"
+                              "  .nested: {\n"
+                              "    .x: `raw } ]`\n"
+                              "    .port: Uint8 7\n"
+                              "  }\n"
+                              "  .dup: 1\n"
+                              "  .dup: 2\n"
+                              "  .broken: Int3 5\n"
+                              "}\n";
+
+TEST_CASE("SIN lazy: lookups match the tree")
+{
+    SinLazyDocument lazy(document);
+    SinLazyValue root = lazy.root();
+
+    CHECK(root.typeId() == SinType::Object);
+    CHECK(root.size() == 8);
+    CHECK(root["name"].asString() == "node");
+    CHECK(root["port"].asUint16() == 8080);
+    CHECK(root["with space"].asBool());
+    CHECK(root["plain"].asDouble() == 2.5);
+    CHECK(root["nested"]["x"].asString() == "raw } ]");
+    CHECK(root["nested"]["port"].asUint8() == 7);
+    CHECK(root["dup"].asInt32() == 2);
+    CHECK_FALSE(root.find("missing").has_value());
+    CHECK_THROWS_AS(root["missing"], std::out_of_range);
+
+    SinLazyValue limits = root["limits"];
+    CHECK(limits.typeId() == SinType::Array);
+    CHECK(limits.size() == 4);
+    CHECK(limits[0].asInt32() == 1);
+    // holes read as they do in the tree
+    CHECK(limits[1].typeId() == SinType::Undefined);
+    CHECK(limits[1].value().typeId() == SinType::Undefined);
+    CHECK_THROWS(limits[1].size());
+    CHECK_THROWS(limits[1].find("x"));
+    CHECK(limits[3].asInt64() == 4);
+    CHECK_THROWS_AS(limits[4], std::out_of_range);
+
+    CHECK(root["nested"].value().toString() == Sin::parse(": {\n  .x: `raw } ]`\n  .port: Uint8 7\n}").toString());
+    CHECK(root["limits"].value().toString() == Sin::parse(": [\n  [0]: 1\n  [3]: Int64 4\n]").toString());
+}
+
+TEST_CASE("SIN lazy: errors")
+{
+    SinLazyDocument lazy(document);
+
+    // values are only checked when they are read
+    CHECK(lazy.root()["name"].asString() == "node");
+    try
+    {
+        lazy.root()["broken"].value();
+        FAIL("no exception");
+    }
+    catch (const std::invalid_argument &e)
+    {
+        CHECK(std::string(e.what()) == "Can't parse configuration: \nUnsupported type: Int3 at line 16");
+    }
+
+    // broken structure is found by the index pass
+    CHECK_THROWS_AS(SinLazyDocument(": {\n  .a: [\n    [0]: 1\n}"), std::invalid_argument);
+    CHECK_THROWS_AS(SinLazyDocument(": {\n  .a: 1\n"), std::invalid_argument);
+}
+
+TEST_CASE("SIN lazy: scalar root")
+{
+    SinLazyDocument lazy(": Uint32 42");
+    CHECK(lazy.nodeCount() == 1);
+    CHECK(lazy.root().asUint32() == 42);
+}
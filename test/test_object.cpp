@@ -0,0 +1,226 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin.h"
+
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+static void requireSame(const SinObject &object, const std::map<std::string, int> &expected)
+{
+  REQUIRE(object.size() == expected.size());
+  auto it = object.begin();
+  for (const auto &[key, value] : expected)
+  {
+    REQUIRE(std::string_view(it->first) == key);
+    REQUIRE(it->second.asInt32() == value);
+    REQUIRE(object.find(key) == it);
+    auto next = it;
+    ++next;
+    REQUIRE(++object.find(key) == next);
+    if (it != object.begin())
+    {
+      auto previous = it;
+      --previous;
+      REQUIRE(--object.find(key) == previous);
+    }
+    it = next;
+  }
+}
+
+TEST_CASE("SinObject: same content and order as std::map")
+{
+  for (int size : {5, 15, 16, 17, 300})
+  {
+    std::vector<int> order(size);
+    for (int i = 0; i < size; i++)
+    {
+      order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(size));
+
+    SinObject object;
+    std::map<std::string, int> expected;
+    for (int i : order)
+    {
+      std::string key = "k" + std::to_string(i);
+      object[key] = i;
+      expected[key] = i;
+    }
+    INFO(size << " keys");
+    requireSame(object, expected);
+
+    REQUIRE_FALSE(object.try_emplace("k0", Sin(-1)).second);
+    REQUIRE(object.insert_or_assign("k0", Sin(-1)).second == false);
+    expected["k0"] = -1;
+    REQUIRE(object.contains("k0"));
+    REQUIRE_FALSE(object.contains("missing"));
+    REQUIRE(object.find("missing") == object.end());
+
+    for (int i = 0; i < size; i += 3)
+    {
+      std::string key = "k" + std::to_string(i);
+      REQUIRE(object.erase(key) == 1);
+      expected.erase(key);
+    }
+    REQUIRE(object.erase("missing") == 0);
+    requireSame(object, expected);
+
+    SinObject copy = object;
+    requireSame(copy, expected);
+  }
+}
+
+TEST_CASE("SinObject: erasing and adding in any order")
+{
+  std::mt19937 random(7);
+  SinObject object;
+  std::map<std::string, int> expected;
+  for (int round = 0; round < 40; round++)
+  {
+    // grow past the index, then shrink below it now and then
+    const int adds = round % 8 == 7 ? 0 : 2000;
+    for (int i = 0; i < adds; i++)
+    {
+      std::string key = "k" + std::to_string(random() % 5000);
+      object.insert_or_assign(key, Sin(i));
+      expected[key] = i;
+    }
+    const size_t erases = round % 8 == 7 ? expected.size() - 3 : random() % 1500;
+    for (size_t i = 0; i < erases && !expected.empty(); i++)
+    {
+      std::string key = round % 2 ? "k" + std::to_string(random() % 5000) : std::next(expected.begin(), random() % expected.size())->first;
+      REQUIRE(object.erase(key) == expected.erase(key));
+    }
+    INFO("round " << round);
+    requireSame(object, expected);
+  }
+
+  // copies and moves keep what was erased out
+  SinObject copy = object;
+  requireSame(copy, expected);
+  SinObject moved = std::move(copy);
+  requireSame(moved, expected);
+  REQUIRE(copy.empty());
+
+  static_assert(std::is_nothrow_move_assignable_v<SinObject>);
+  std::pmr::monotonic_buffer_resource arena;
+  SinObject elsewhere{SinObject::allocator_type(&arena)};
+  elsewhere = std::move(moved);
+  requireSame(elsewhere, expected);
+  REQUIRE(moved.empty());
+  REQUIRE(elsewhere.get_allocator().resource() == &arena);
+}
+
+TEST_CASE("SinObject: erasing most of a large object")
+{
+  SinObject object;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 100000; i++)
+  {
+    std::string key = "member_" + std::to_string(i * 7919 % 100000);
+    object[key] = i;
+    expected[key] = i;
+  }
+  for (int i = 0; i < 100000; i++)
+  {
+    if (i % 10 != 0)
+    {
+      std::string key = "member_" + std::to_string(i);
+      REQUIRE(object.erase(key) == 1);
+      expected.erase(key);
+    }
+  }
+  requireSame(object, expected);
+  REQUIRE(object.erase("member_1") == 0);
+  object["member_1"] = -1;
+  expected["member_1"] = -1;
+  requireSame(object, expected);
+}
+
+TEST_CASE("SinObject: unsorted appends")
+{
+  for (int size : {4, 40})
+  {
+    SinObject object;
+    std::map<std::string, int> expected;
+    for (int i = size - 1; i >= 0; i--)
+    {
+      std::string key = "k" + std::to_string(i % (size / 2));
+      object.appendUnsorted(key, Sin(i));
+      expected[key] = i;
+    }
+    object.sortKeys();
+    requireSame(object, expected);
+
+    // sorted input is only checked
+    object.sortKeys();
+    requireSame(object, expected);
+  }
+}
+
+TEST_CASE("SinObject: references survive inserts")
+{
+  Sin sin = Sin::Object();
+  sin["b"] = "x";
+  sin["a"] = sin["b"];
+  REQUIRE(sin["a"].asStringView() == "x");
+  REQUIRE(sin["b"].asStringView() == "x");
+
+  // across the switch to the index and its growth, inserts before and after
+  SinObject object;
+  Sin &held = object["m"];
+  held = 1;
+  const SinKey *heldKey = &object.begin()->first;
+  for (int i = 0; i < int(SinObject::INDEX_MIN) * 4; i++)
+  {
+    object[(i % 2 ? "a" : "z") + std::to_string(i)] = i;
+    held = held.asInt32() + 1;
+  }
+  REQUIRE(&object["m"] == &held);
+  REQUIRE(&object.find("m")->first == heldKey);
+  REQUIRE(held.asInt32() == 1 + int(SinObject::INDEX_MIN) * 4);
+
+  // and erases of other members, compactions included
+  for (int i = 0; i < int(SinObject::INDEX_MIN) * 4; i++)
+  {
+    object.erase((i % 2 ? "a" : "z") + std::to_string(i));
+  }
+  REQUIRE(object.size() == 1);
+  REQUIRE(&object["m"] == &held);
+}
+
+TEST_CASE("SinObject: keys are interned")
+{
+  const size_t poolBefore = SinKey::poolSize();
+  {
+    Sin first = Sin::parse(": {\n  [\"a long key that is not in the pool yet\"]: 1\n  .b: 2\n}");
+    Sin second = Sin::parse(": {\n  [\"a long key that is not in the pool yet\"]: 3\n}");
+    const SinKey &key = first.asObject().begin()->first;
+    REQUIRE(key == second.asObject().begin()->first);
+    REQUIRE(key.view().data() == second.asObject().begin()->first.view().data());
+    REQUIRE(key.hash() == SinKey::hashOf("a long key that is not in the pool yet"));
+    REQUIRE(SinKey::poolSize() >= poolBefore + 1);
+
+    // looking up by key or by text, with and without an index
+    for (int size : {2, 40})
+    {
+      SinObject object;
+      for (int i = 0; i < size; i++)
+      {
+        object.try_emplace(SinKey("k" + std::to_string(i)), Sin(i));
+      }
+      object["a long key that is not in the pool yet"] = Sin(-1);
+      REQUIRE(object.find(key)->second.asInt32() == -1);
+      REQUIRE(object[SinKey("k1")].asInt32() == 1);
+      REQUIRE(object.find(SinKey("missing")) == object.end());
+      REQUIRE(object.find("a long key that is not in the pool yet") == object.find(key));
+    }
+  }
+  // a text leaves the pool with its last key
+  REQUIRE(SinKey::poolSize() == poolBefore);
+  REQUIRE(SinKey("").view().empty());
+}
@@ -0,0 +1,176 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin.h"
+#include "sin_binary.h"
+#include "sin_parser.h"
+#include "sin_sax.h"
+#include "sin_stream_parser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * The same elements as a regular array, which is never packed
+ */
+template <class T>
+static std::string unpackedText(const std::vector<T> &values)
+{
+    Sin array = Sin::Array();
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        array.asArray().push_back(values[i]);
+    }
+    return array.toString();
+}
+
+TEST_CASE("Packed arrays: parsed arrays of one number type")
+{
+    std::vector<float> floats;
+    std::vector<int32_t> ints;
+    for (int i = 0; i < int(SinTreeBuilder::PACK_MIN) + 4; i++)
+    {
+        floats.push_back(i * 0.25f);
+        ints.push_back(i * i - 10);
+    }
+
+    Sin sin = Sin::parse(unpackedText(floats));
+    auto span = sin.asSpan<float>();
+    REQUIRE(span.size() == floats.size());
+    CHECK(std::equal(span.begin(), span.end(), floats.begin()));
+    CHECK(sin.typeId() == SinType::Array);
+    CHECK(sin.toString() == unpackedText(floats));
+    CHECK_THROWS(sin.asSpan<double>());
+
+    Sin untyped = Sin::parse(unpackedText(ints));
+    CHECK(untyped.asSpan<int32_t>()[3] == -1);
+    CHECK(untyped.toString() == unpackedText(ints));
+
+    SinFormat compact;
+    compact.compact = true;
+    CHECK(untyped.toString(compact) == Sin::parse(unpackedText(ints)).toString(compact));
+    CHECK(untyped.toStringParallel(3) == untyped.toString());
+
+    // const access doesn't make Sin elements, the buffer is all there is
+    const Sin &constSin = sin;
+    CHECK(constSin.packedType() == SinType::Float);
+    CHECK_THROWS(constSin.asArray());
+    CHECK(sin.asSpan<float>().data() == span.data());
+    CHECK(Sin::parse(": [\n  [0]: 1\n]").packedType() == SinType::Undefined);
+
+    // packing a packed array keeps its buffer
+    SinTreeBuilder::packArray(sin);
+    CHECK(sin.asSpan<float>().data() == span.data());
+}
+
+/**
+ * Code that only reads a tree, it can't tell packed arrays apart
+ */
+static double sumOf(const Sin &array)
+{
+    double sum = 0;
+    for (size_t i = 0; i < array.size(); i++)
+    {
+        sum += array.at(i).get<double>();
+    }
+    return sum;
+}
+
+TEST_CASE("Packed arrays: const readers")
+{
+    std::vector<int32_t> ints;
+    for (int i = 0; i < int(SinTreeBuilder::PACK_MIN) + 4; i++)
+    {
+        ints.push_back(i * 3 - 7);
+    }
+    const double expected = 3.0 * (ints.size() * (ints.size() - 1) / 2) - 7.0 * ints.size();
+
+    const Sin packed = Sin::parse(unpackedText(ints));
+    REQUIRE(packed.packedType() == SinType::Int32);
+    CHECK(sumOf(packed) == expected);
+    CHECK(packed.at(2).typeId() == SinType::Int32);
+    CHECK(packed.at(2).asInt32() == -1);
+    CHECK_THROWS_AS(packed.at(ints.size()), std::out_of_range);
+    // reading didn't unpack
+    CHECK(packed.packedType() == SinType::Int32);
+
+    Sin regular = Sin::Array();
+    for (int32_t value : ints)
+    {
+        regular.asArray().push_back(value);
+    }
+    CHECK(sumOf(regular) == expected);
+
+    const Sin object = Sin::parse(": {\n  .a: 1\n  .b: 2\n}");
+    CHECK(object.size() == 2);
+    CHECK_THROWS(object.at(0));
+    CHECK_THROWS(Sin(1).size());
+}
+
+TEST_CASE("Packed arrays: every parser and the binary form pack")
+{
+    std::vector<int32_t> ints;
+    for (int i = 0; i < int(SinTreeBuilder::PACK_MIN) * 8; i++)
+    {
+        ints.push_back(i * 3);
+    }
+    const std::string text = unpackedText(ints);
+
+    // the root array, which these build without a SinTreeBuilder
+    std::istringstream stream(text);
+    CHECK(parseSinStream(stream).asSpan<int32_t>().size() == ints.size());
+    for (unsigned threads : {1u, 3u})
+    {
+        CHECK(parseSinParallel(text, threads).asSpan<int32_t>()[5] == 15);
+    }
+
+    // encoded from the buffer, the same bytes as the unpacked array
+    Sin packed = Sin::parse(text);
+    Sin unpacked = packed;
+    unpacked.asArray();
+    REQUIRE(unpacked.packedType() == SinType::Undefined);
+    const std::string binary = sinToBinary(packed);
+    CHECK(binary == sinToBinary(unpacked));
+    CHECK(SinBinaryView::root(binary).toSin().asSpan<int32_t>().size() == ints.size());
+}
+
+TEST_CASE("Packed arrays: what is not packed")
+{
+    // too short, mixed types, bools
+    CHECK_THROWS(Sin::parse(": [\n  [0]: 1.5\n  [1]: 2.5\n]").asSpan<double>());
+
+    Sin mixed = Sin::Array();
+    Sin bools = Sin::Array();
+    for (int i = 0; i < 20; i++)
+    {
+        mixed.asArray().push_back(i % 2 ? Sin(i) : Sin(int64_t(i)));
+        bools.asArray().push_back(i % 2 == 0);
+    }
+    CHECK_FALSE(Sin::parse(mixed.toString()).pack());
+    CHECK_FALSE(bools.pack());
+    CHECK_FALSE(Sin::Array().pack());
+    CHECK_FALSE(Sin(5).pack());
+}
+
+TEST_CASE("Packed arrays: changes unpack the changed copy only")
+{
+    Sin doubles = {1.0, 2.5, -0.0, std::numeric_limits<double>::infinity()};
+    const std::string text = doubles.toString();
+    REQUIRE(doubles.pack());
+    CHECK(doubles.toString() == text);
+
+    Sin copy = doubles;
+    copy[1] = 7.0;
+    copy.asArray().push_back(8.0);
+    CHECK(copy.toString() != text);
+    CHECK(doubles.asSpan<double>()[1] == 2.5);
+    CHECK(doubles.toString() == text);
+    CHECK_THROWS(copy.asSpan<double>());
+
+    REQUIRE(copy.pack());
+    CHECK(copy.asSpan<double>().size() == 5);
+    CHECK(std::isinf(copy.asSpan<double>()[3]));
+}
@@ -0,0 +1,78 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_parser.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::string bigObject(int members)
+{
+    std::string text = ": {\n";
+    for (int i = 0; i < members; i++)
+    {
+        std::string key = i % 7 == 0 ? "[\"key " + std::to_string(i % 50) + "\"]" : ".m" + std::to_string(i);
+        text += "  " + key + ": {\n    .id: " + std::to_string(i) + "\n    .port: Uint16 " + std::to_string(8000 + i) +
+                "\n    .text: `a } ]\nb`\n    .list: [\n      [0]: 1.5\n      [2]: true\n    ]\n  }\n";
+    }
+    return text + "}\n";
+}
+
+static std::string bigArray(int elements)
+{
+    std::string text = ": [\n";
+    for (int i = 0; i < elements; i++)
+    {
+        text += "  [" + std::to_string(i % 3 == 0 ? i + 1 : i) + "]: \"s" + std::to_string(i) + "\"\n";
+    }
+    return text + "]";
+}
+
+/**
+ * The tree or the error, sequentially for 0 threads
+ */
+static std::string parseResult(const std::string &text, unsigned threads)
+{
+    try
+    {
+        return (threads == 0 ? parseSin(text) : parseSinParallel(text, threads)).toString();
+    }
+    catch (const std::invalid_argument &e)
+    {
+        return std::string("error: ") + e.what();
+    }
+}
+
+TEST_CASE("SIN parallel parser: same result as parseSin")
+{
+    std::string broken = bigObject(300);
+    broken.replace(broken.rfind("Uint16 8250"), 11, "Uint8 8250");
+
+    std::string unclosed = bigObject(300);
+    unclosed.resize(unclosed.size() - 2);
+
+    const std::vector<std::string> documents = {
+        bigObject(300),
+        bigArray(500),
+        broken,
+        unclosed,
+        ": {\n  .a: 1\n  .b: Unknown 5\n  .c: 2\n}\n",
+        ": {\n  .a: 1\n  .a: 2\n}\n: trailing content",
+        ": [\n  [0]: 1\n  [x]: 2\n  [2]: 3\n]\n",
+        ":{.a:1 .b:\"x\" .c:[[0]:true ]}",
+        ": 12345",
+        "",
+    };
+
+    for (auto &text : documents)
+    {
+        std::string expected = parseResult(text, 0);
+        for (unsigned threads : {1u, 2u, 3u, 8u})
+        {
+            INFO(threads << " threads: " << text.substr(0, 60));
+            CHECK(parseResult(text, threads) == expected);
+        }
+    }
+
+    CHECK(parseResult(broken, 4).find("Out of bounds") != std::string::npos);
+}
@@ -4,6 +4,9 @@
 #include "sin_parser.h"
 #include "sin_parser_impl.h"
 
+#include <string>
+#include <vector>
+
 TEST_CASE("SIN parser: integer values out of bounds")
 {
     // Unsigned
@@ -560,3 +563,217 @@ TEST_CASE("SIN parser")
         CHECK(sp.error != "");
     }
 }
+
+
+TEST_CASE("SIN parser: string_view input")
+{
+    SECTION("View into a larger buffer")
+    {
+        std::string buffer = ": {\n  .a: 12\n  .b: \"x\\ty\"\n}\n: Int8 5";
+        std::string_view view(buffer.data(), buffer.find("}") + 1);
+        SinParser sp(view);
+        CHECK(sp.error == "");
+        CHECK(sp.value["a"].asInt32() == 12);
+        CHECK(sp.value["b"].asString() == "x\ty");
+    }
+
+    SECTION("Number at the end of the view")
+    {
+        std::string buffer = ": 123456";
+        SinParser sp(std::string_view(buffer.data(), 5));
+        CHECK(sp.error == "");
+        CHECK(sp.value.asInt32() == 123);
+    }
+
+    SECTION("Sin::parse")
+    {
+        std::string_view view = ": [\n  [0]: true\n]";
+        CHECK(Sin::parse(view)[0].asBool() == true);
+    }
+}
+
+TEST_CASE("SIN parser: number classification")
+{
+    SECTION("Untyped numbers")
+    {
+        SinParser sp(": [\n"
+                     "  [0]: 2147483647\n"
+                     "  [1]: -2147483649\n"
+                     "  [2]: 18446744073709551615\n"
+                     "  [3]: 18446744073709551616\n"
+                     "  [4]: +7\n"
+                     "  [5]: -0.5e-3\n"
+                     "  [6]: 1e2\n"
+                     "]");
+        REQUIRE(sp.error == "");
+        CHECK(sp.value[0].asInt32() == 2147483647);
+        CHECK(sp.value[1].asInt64() == -2147483649ll);
+        CHECK(sp.value[2].asUint64() == 18446744073709551615ull);
+        CHECK(sp.value[3].asDouble() == Catch::Approx(18446744073709551616.0));
+        CHECK(sp.value[4].asInt32() == 7);
+        CHECK(sp.value[5].asDouble() == Catch::Approx(-0.0005));
+        CHECK(sp.value[6].asDouble() == Catch::Approx(100));
+    }
+
+    SECTION("Invalid untyped numbers")
+    {
+        CHECK(SinParser(": 12abc").error != "");
+        CHECK(SinParser(": +-1").error != "");
+        CHECK(SinParser(": -").error != "");
+    }
+
+    SECTION("Typed numbers")
+    {
+        CHECK(SinParser(": Int64 -9223372036854775808").value.asInt64() == INT64_MIN);
+        CHECK(SinParser(": Uint8 +255").value.asUint8() == 255);
+        CHECK(SinParser(": Float 1.5").value.asFloat() == Catch::Approx(1.5));
+        CHECK(SinParser(": Int64 9223372036854775808").error.find("Out of bounds") != std::string::npos);
+        CHECK(SinParser(": Int16 5abc").error.find("Invalid number") != std::string::npos);
+        CHECK(SinParser(": Double 1e").error.find("Invalid number") != std::string::npos);
+    }
+}
+
+namespace
+{
+    struct CountingResource : std::pmr::memory_resource
+    {
+        size_t allocations = 0;
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST_CASE("SIN parser: arena")
+{
+    std::string str = ": {\n"
+                      "  .name: \"a string that does not fit the small string buffer\"\n"
+                      "  .list: [\n"
+                      "    [0]: 1\n"
+                      "    [1]: {\n"
+                      "      .x: Uint8 7\n"
+                      "    }\n"
+                      "  ]\n"
+                      "}\n";
+
+    SECTION("Same tree as the default parse")
+    {
+        SinArena arena;
+        Sin sin = Sin::parse(str, arena);
+        CHECK(sin.toString() == Sin::parse(str).toString());
+        CHECK(sin["list"][1]["x"].asUint8() == 7);
+
+        sin["added"] = "later";
+        CHECK(sin["added"].asString() == "later");
+    }
+
+    SECTION("Nodes come from the given resource")
+    {
+        CountingResource resource;
+        {
+            Sin sin = parseSin(str, &resource);
+            CHECK(sin["name"].asString() == "a string that does not fit the small string buffer");
+        }
+        // root, name, list, list[1] and their containers
+        CHECK(resource.allocations >= 4);
+    }
+}
+
+TEST_CASE("SIN parser: reused for many documents")
+{
+    const std::vector<std::string> documents = {
+        ": {\n  .id: 1\n  .name: \"plain\"\n  .nested: {\n    .x: Uint8 7\n    .name: `\nraw\n`\n  }\n}",
+        ": {\n  .id: 2\n  [\"with space\"]: \"esc\\\"aped \\\\ text that is longer than a small string\"\n}",
+        ": [\n  [0]: 1\n  [1]: \"two\"\n]",
+        ": 5",
+    };
+
+    SinParser parser;
+    for (int round = 0; round < 3; round++)
+    {
+        for (const auto &document : documents)
+        {
+            CHECK(parser.parse(document).toString() == parseSin(document).toString());
+        }
+    }
+
+    SECTION("An error does not leak into the next document")
+    {
+        CHECK_THROWS_AS(parser.parse(": {\n  .id: 1\n  .broken: {\n    .x:"), std::invalid_argument);
+        CHECK(parser.parse(documents[0]).toString() == parseSin(documents[0]).toString());
+    }
+
+    SECTION("Arena and SAX parses")
+    {
+        SinArena arena;
+        CHECK(parser.parse(documents[1], arena.resource()).toString() == parseSin(documents[1]).toString());
+
+        SinTreeBuilder builder;
+        parser.parse(documents[0], builder);
+        CHECK(builder.result().toString() == parseSin(documents[0]).toString());
+    }
+}
+
+TEST_CASE("SIN parser: sparse and out of order arrays")
+{
+    SECTION("Holes are undefined and are left out when written")
+    {
+        const std::string str = ": [\n  [5]: 5\n  [1]: 1\n  [100000]: \"last\"\n]\n";
+        Sin sin = Sin::parse(str);
+        REQUIRE(sin.asArray().size() == 100001);
+        CHECK(sin[1].asInt32() == 1);
+        CHECK(sin[5].asInt32() == 5);
+        CHECK(sin[0].typeId() == SinType::Undefined);
+        CHECK(sin[99999].typeId() == SinType::Undefined);
+        CHECK(sin[100000].asString() == "last");
+        CHECK(sin.toString() == ": [\n  [1]: 1\n  [5]: 5\n  [100000]: \"last\"\n]\n");
+        CHECK(Sin::parse(sin.toString()).toString() == sin.toString());
+
+        // on its own there is nothing to write
+        CHECK(Sin::Undefined().toString().empty());
+        CHECK(sin[0].toString().empty());
+    }
+
+    SECTION("A repeated index keeps the last value")
+    {
+        Sin sin = Sin::parse(": [\n  [0]: 1\n  [0]: 2\n]");
+        REQUIRE(sin.asArray().size() == 1);
+        CHECK(sin[0].asInt32() == 2);
+    }
+
+    SECTION("Indexing past the end pads with undefined values")
+    {
+        Sin sin = Sin::Array();
+        sin[3] = 3;
+        REQUIRE(sin.asArray().size() == 4);
+        CHECK(sin[2].typeId() == SinType::Undefined);
+        sin[2]["x"] = 1;
+        CHECK(sin[2]["x"].asInt32() == 1);
+    }
+
+    SECTION("Invalid indexes are errors")
+    {
+        for (const char *index : {"-1", "1x", "+-1", "x", "99999999999", ""})
+        {
+            INFO(index);
+            SinParser sp(std::string(": [\n  [") + index + "]: 1\n]");
+            CHECK(sp.error.find("Invalid array index") != std::string::npos);
+        }
+        SinParser sp(": [\n  [+2]: 1\n]");
+        CHECK(sp.error.empty());
+        CHECK(sp.value[2].asInt32() == 1);
+    }
+}
@@ -0,0 +1,159 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_parser.h"
+#include "sin_parser_impl.h"
+#include "sin_sax.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * Records events as text, skips or stops at the given keys
+     */
+    struct RecordingHandler : SinSaxHandler
+    {
+        std::vector<std::string> events;
+        std::string skipKey;
+        std::string stopKey;
+        bool skipArrays = false;
+
+        SinSaxAction onObjectBegin() override
+        {
+            events.push_back("{");
+            return SinSaxAction::Continue;
+        }
+
+        SinSaxAction onArrayBegin() override
+        {
+            events.push_back("[");
+            return skipArrays ? SinSaxAction::Skip : SinSaxAction::Continue;
+        }
+
+        SinSaxAction onKey(std::string_view key) override
+        {
+            events.push_back("." + std::string(key));
+            if (key == stopKey)
+            {
+                return SinSaxAction::Stop;
+            }
+            return key == skipKey ? SinSaxAction::Skip : SinSaxAction::Continue;
+        }
+
+        SinSaxAction onArrayIndex(size_t index) override
+        {
+            events.push_back("#" + std::to_string(index));
+            return SinSaxAction::Continue;
+        }
+
+        SinSaxAction onScalar(const SinSaxScalar &scalar) override
+        {
+            events.push_back(std::string(sinTypeName(scalar.type)) + " " + std::string(scalar.text));
+            return SinSaxAction::Continue;
+        }
+
+        SinSaxAction onEnd() override
+        {
+            events.push_back("end");
+            return SinSaxAction::Continue;
+        }
+    };
+}
+
+static const char *document = ": {\n"
+                              "  .a: 1\n"
+                              "  .skipped: {\n"
+                              "    .x: \"} ] not the end \\\" `\"\n"
+                              "    .na{me: `raw } ]`\n"
+                              "    [\"} ]\"]: 2\n"
+                              "    .y: [\n"
+                              "      [0]: Uint8 5\n"
+                              "      [1]: 1\n"
+                              "    ]\n"
+                              "  }\n"
+                              "  .typed: Uint16\n  8080\n"
+                              "  .list: [\n"
+                              "    [0]: true\n"
+                              "    [1]: \"s\"\n"
+                              "  ]\n"
+                              "  .last: -2.5\n"
+                              "}\n";
+
+TEST_CASE("SIN SAX: events")
+{
+    RecordingHandler handler;
+    parseSin(": {\n  .a: 1\n  .b: [\n    [0]: Uint8 5\n    [2]: \"x\"\n  ]\n  .c: true\n  .d: 1e3\n}", handler);
+
+    std::vector<std::string> expected = {
+        "{", ".a", "Int32 1", ".b", "[", "#0", "Uint8 5", "#2", "String x", "end", ".c", "Bool true", ".d", "Double 1e3", "end"};
+    CHECK(handler.events == expected);
+}
+
+TEST_CASE("SIN SAX: skip and stop")
+{
+    SECTION("Skip a member")
+    {
+        RecordingHandler handler;
+        handler.skipKey = "skipped";
+        parseSin(document, handler);
+        std::vector<std::string> expected = {
+            "{", ".a", "Int32 1", ".skipped", ".typed", "Uint16 8080", ".list", "[", "#0", "Bool true", "#1", "String s", "end", ".last", "Double -2.5", "end"};
+        CHECK(handler.events == expected);
+    }
+
+    SECTION("Skip scalar members")
+    {
+        RecordingHandler all;
+        parseSin(document, all);
+
+        for (const char *key : {"a", "typed", "last"})
+        {
+            RecordingHandler handler;
+            handler.skipKey = key;
+            parseSin(document, handler);
+            CHECK(handler.events.size() == all.events.size() - 1);
+            CHECK(handler.events.back() == "end");
+        }
+    }
+
+    SECTION("Skip containers from their begin event")
+    {
+        RecordingHandler handler;
+        handler.skipArrays = true;
+        parseSin(document, handler);
+        CHECK(std::count(handler.events.begin(), handler.events.end(), "end") == 2);
+        CHECK(handler.events.back() == "end");
+    }
+
+    SECTION("Stop")
+    {
+        RecordingHandler handler;
+        handler.stopKey = "typed";
+        parseSin(document, handler);
+        CHECK(handler.events.back() == ".typed");
+    }
+
+    SECTION("Line numbers after a skip")
+    {
+        RecordingHandler handler;
+        handler.skipKey = "skipped";
+        SinParser parser(std::string(document) + ": oops", handler);
+        CHECK(parser.error == "");
+
+        std::string broken = document;
+        broken.replace(broken.find("-2.5"), 4, "Int3 2");
+        SinParser failing(broken, handler);
+        CHECK(failing.error == "\nUnsupported type: Int3 at line 17");
+    }
+}
+
+TEST_CASE("SIN SAX: tree builder")
+{
+    SinTreeBuilder builder;
+    parseSin(document, builder);
+    CHECK(builder.result().toString() == Sin::parse(document).toString());
+
+    CHECK_THROWS_AS(parseSin(": {\n  .a: Int3 1\n}", builder), std::invalid_argument);
+}
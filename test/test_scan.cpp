@@ -0,0 +1,72 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_parser.h"
+#include "sin_scan.h"
+
+#include <random>
+#include <string>
+
+static std::string randomText(std::mt19937 &rng, size_t size, const std::string &alphabet)
+{
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::string text;
+    for (size_t i = 0; i < size; i++)
+    {
+        text += alphabet[pick(rng)];
+    }
+    return text;
+}
+
+TEST_CASE("SIN scan kernels match the scalar implementation")
+{
+    const SinScanKernels &scalar = *sinScanKernelsFor(SinScanLevel::Scalar);
+    std::mt19937 rng(42);
+
+    for (auto level : {SinScanLevel::SSE2, SinScanLevel::AVX2})
+    {
+        const SinScanKernels *kernels = sinScanKernelsFor(level);
+        if (!kernels)
+        {
+            continue;
+        }
+        INFO(kernels->name);
+
+        for (int i = 0; i < 2000; i++)
+        {
+            size_t size = i % 150;
+            // mostly whitespace so runs cross block boundaries
+            std::string text = randomText(rng, size, "                \n\n\t\r\rx");
+            size_t expectedLines = 0;
+            size_t lines = 0;
+            CHECK(kernels->skipWhitespace(text.data(), text.size(), &lines) == scalar.skipWhitespace(text.data(), text.size(), &expectedLines));
+            CHECK(lines == expectedLines);
+
+            std::string body = randomText(rng, size, "abcdefghijklmnopqrstuvwxyz\n\n\n\"`\\");
+            for (char quote : {'"', '`'})
+            {
+                expectedLines = 0;
+                lines = 0;
+                CHECK(kernels->findStringStop(body.data(), body.size(), quote, &lines) == scalar.findStringStop(body.data(), body.size(), quote, &expectedLines));
+                CHECK(lines == expectedLines);
+            }
+        }
+    }
+}
+
+TEST_CASE("SIN scan: line numbers after long strings and indentation")
+{
+    std::string lines;
+    for (int i = 0; i < 100; i++)
+    {
+        lines += "line of a certificate or an embedded script\n";
+    }
+    std::string text = ": {\n"
+                       "  .a: `\n" +
+                       lines + "`\n" + std::string(200, ' ') + "\n\n" +
+                       "  .b: \"" + std::string(100, 'x') + "\\n" + std::string(100, 'y') + "\"\n" +
+                       "  .c: Int8 300\n"
+                       "}\n";
+
+    // lines are counted from 0: .a is on line 1, the closing backtick on line 102, .c on line 106
+    CHECK_THROWS_WITH(parseSin(text), "Can't parse configuration: \nOut of bounds. Can't parse '300' at line 106");
+}
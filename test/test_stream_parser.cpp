@@ -0,0 +1,151 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "sin_parser_impl.h"
+#include "sin_stream_parser.h"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const std::vector<std::string> documents = {
+    ": {\n"
+    "  .id: 12\n"
+    "  .port: Uint16\n  8080\n"
+    "  .ratio: -1.5e-3\n"
+    "  .name: \"tab\\tquote\\\" backslash\\\\\"\n"
+    "  .key: `\nline \\` one\nline two\n`\n"
+    "  [\"spaced key\"]: true\n"
+    "  .list: [\n"
+    "    [0]: 1\n"
+    "    [1]: {\n"
+    "      .deep: Int64 -9000000000\n"
+    "    }\n"
+    "    [3]: false\n"
+    "  ]\n"
+    "  .id: 13\n"
+    "}\n",
+    ": [\n  [0]: 1\n  [1]: \"two\"\n  [2]: [\n    [0]: 3.25\n  ]\n]",
+    ":{.a:1 .b:\"x\" .c:[[0]:true ]}",
+    ": 12345",
+    ": \"just a string\"",
+    ": {\n  .a: 1\n}\n: trailing content",
+    ": {\n  .a: 1\n  .b: Unknown 5\n  .c: 2\n}\n",
+    ": {\n  .a: Uint8 300\n  .b: 1\n}\n",
+    ": {\n  .a: 1\n  .b: {\n    .c: 2\n",
+    ": [\n  [0]: 1\n  [x]: 2\n  [2]: 3\n]\n",
+    ": {\n  .a: 1\n  ! oops\n}\n",
+    ": {\n  .a: \"unterminated\n",
+    "  {",
+    "",
+};
+
+static void requireSameAsParser(const std::string &text, SinStreamParser &stream)
+{
+    SinParser parser(text);
+    INFO(text);
+    REQUIRE(stream.error == parser.error);
+    REQUIRE(stream.value.toString() == parser.value.toString());
+}
+
+TEST_CASE("SIN stream parser: same result as SinParser")
+{
+    SECTION("Single chunk")
+    {
+        for (auto &text : documents)
+        {
+            SinStreamParser stream;
+            stream.feed(text.data(), text.size());
+            stream.finish();
+            requireSameAsParser(text, stream);
+        }
+    }
+
+    SECTION("Two chunks split at every position")
+    {
+        for (auto &text : documents)
+        {
+            for (size_t split = 0; split <= text.size(); split++)
+            {
+                INFO(split);
+                SinStreamParser stream;
+                stream.feed(text.data(), split);
+                stream.feed(text.data() + split, text.size() - split);
+                stream.finish();
+                requireSameAsParser(text, stream);
+            }
+        }
+    }
+
+    SECTION("One byte at a time")
+    {
+        for (auto &text : documents)
+        {
+            SinStreamParser stream;
+            for (char ch : text)
+            {
+                stream.feed(&ch, 1);
+            }
+            stream.finish();
+            requireSameAsParser(text, stream);
+        }
+    }
+
+    SECTION("Random chunks of a large document")
+    {
+        std::string text = ": {\n";
+        for (int i = 0; i < 2000; i++)
+        {
+            text += "  .k" + std::to_string(i) + ": [\n    [0]: " + std::to_string(i * 0.5) + "\n    [1]: \"s\\n" + std::to_string(i) + "\"\n  ]\n";
+        }
+        text += "}\n";
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<size_t> chunk(1, 300);
+        SinStreamParser stream;
+        for (size_t pos = 0; pos < text.size();)
+        {
+            size_t size = std::min(chunk(rng), text.size() - pos);
+            stream.feed(text.data() + pos, size);
+            pos += size;
+        }
+        stream.finish();
+        requireSameAsParser(text, stream);
+    }
+}
+
+TEST_CASE("SIN stream parser: one large nested member")
+{
+    // a single member of the root holds everything, with containers inside
+    std::string text = ": {\n  .tables: {\n";
+    for (int i = 0; i < 3000; i++)
+    {
+        text += "    .t" + std::to_string(i) + ": [\n      [0]: " + std::to_string(i) + "\n      [1]: {\n        .name: \"table " +
+                std::to_string(i) + "\"\n      }\n    ]\n";
+    }
+    text += "  }\n}\n";
+
+    // a retry parses no more than is buffered, and only the unfinished
+    // scalar or key is, however large the member around it is
+    SinStreamParser stream;
+    size_t most = 0;
+    for (char ch : text)
+    {
+        stream.feed(&ch, 1);
+        most = std::max(most, stream.buffered());
+    }
+    stream.finish();
+    requireSameAsParser(text, stream);
+    CHECK(text.size() > 200000);
+    CHECK(most < 64);
+}
+
+TEST_CASE("SIN stream parser: istream")
+{
+    std::istringstream valid(documents[0]);
+    CHECK(parseSinStream(valid).toString() == Sin::parse(documents[0]).toString());
+
+    std::istringstream invalid(documents[6]);
+    CHECK_THROWS_AS(parseSinStream(invalid), std::invalid_argument);
+}